@@ -0,0 +1,179 @@
+#include "AnalysisDecimator.h"
+#include <cmath>     // For std::sin, std::sqrt, std::ceil
+#include <algorithm> // For std::fill, std::copy
+
+//==============================================================================
+double AnalysisDecimator::besselI0(double x)
+{
+    // Power series; converges quickly for the beta values used here
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1.0e-12)
+            break;
+    }
+    return sum;
+}
+
+//==============================================================================
+void AnalysisDecimator::Stage::design(double inputRate)
+{
+    // A half-band filter is symmetric about a quarter of the input rate, so the
+    // stopband starts where the passband would alias to: outputRate - passband.
+    const double outputRate = inputRate / 2.0;
+    const double passband = juce::jmin(passbandEdgeHz, 0.45 * outputRate);
+    const double transition = (outputRate - 2.0 * passband) / inputRate;
+
+    // Kaiser's estimates for length and shape
+    const double beta = 0.1102 * (stopbandAttenuationDb - 8.7);
+    const int estimatedLength = static_cast<int>(std::ceil((stopbandAttenuationDb - 8.0)
+                                                           / (2.285 * juce::MathConstants<double>::twoPi * transition))) + 1;
+
+    // Half-length must be odd so the outermost taps are non-zero ones
+    halfLength = juce::jmax(1, estimatedLength / 2);
+    if (halfLength % 2 == 0)
+        ++halfLength;
+
+    oddTaps.clear();
+    double dcGain = 0.5;
+    for (int j = 1; j <= halfLength; j += 2)
+    {
+        const double ratio = static_cast<double>(j) / halfLength;
+        const double window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - ratio * ratio))) / besselI0(beta);
+        const double ideal = std::sin(juce::MathConstants<double>::halfPi * j) / (juce::MathConstants<double>::pi * j);
+        oddTaps.push_back(static_cast<float>(ideal * window));
+        dcGain += 2.0 * ideal * window;
+    }
+
+    // Normalise to exactly unity gain at DC
+    for (auto& tap : oddTaps)
+        tap = static_cast<float>(tap / dcGain);
+    centreTap = static_cast<float>(0.5 / dcGain);
+}
+
+void AnalysisDecimator::Stage::reset()
+{
+    for (auto& line : lines)
+        std::fill(line.begin(), line.end(), 0.0f);
+    phase = 0;
+}
+
+int AnalysisDecimator::Stage::process(const float* const* input, int numChannels, int numSamples, float* const* output)
+{
+    const int historyLength = 2 * halfLength;
+    const int numTaps = static_cast<int>(oddTaps.size());
+    int numOutput = 0;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& line = lines[static_cast<size_t>(ch)];
+        jassert(static_cast<int>(line.size()) >= historyLength + numSamples);
+
+        std::copy(input[ch], input[ch] + numSamples, line.begin() + historyLength);
+        const float* data = line.data();
+        const float* taps = oddTaps.data();
+        float* out = output[ch];
+
+        numOutput = 0;
+        for (int i = phase; i < numSamples; i += 2)
+        {
+            // data[i + halfLength] is the centre of the window ending at input sample i
+            const float* centre = data + i + halfLength;
+            float sum = centreTap * centre[0];
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const int j = 2 * k + 1;
+                sum += taps[k] * (centre[-j] + centre[j]);
+            }
+            out[numOutput++] = sum;
+        }
+
+        // Keep the newest samples as history for the next block
+        std::copy(line.begin() + numSamples, line.begin() + numSamples + historyLength, line.begin());
+    }
+
+    phase = (numSamples % 2 == 0) ? phase : 1 - phase;
+    return numOutput;
+}
+
+int AnalysisDecimator::Stage::skip(int numSamples)
+{
+    const int numOutput = (numSamples + 1 - phase) / 2;
+
+    for (auto& line : lines)
+        std::fill(line.begin(), line.end(), 0.0f);
+
+    phase = (numSamples % 2 == 0) ? phase : 1 - phase;
+    return numOutput;
+}
+
+//==============================================================================
+void AnalysisDecimator::prepare(double inputSampleRate, int numChannels, int maxSamplesPerBlock, bool shouldDecimate)
+{
+    stages.clear();
+    outputSampleRate = inputSampleRate;
+    maxOutputSamples = juce::jmax(0, maxSamplesPerBlock);
+
+    if (! shouldDecimate)
+        return;
+
+    // Halve until one more halving would drop below 44.1 kHz
+    // (88.2k -> 44.1k, 96k -> 48k, 192k -> 48k, 352.8k -> 44.1k, 384k -> 48k)
+    int maxInput = maxOutputSamples;
+    while (outputSampleRate / 2.0 >= minimumOutputRate)
+    {
+        Stage stage;
+        stage.design(outputSampleRate);
+        stage.lines.assign(static_cast<size_t>(numChannels),
+                           std::vector<float>(static_cast<size_t>(2 * stage.halfLength + maxInput), 0.0f));
+        stages.push_back(std::move(stage));
+
+        outputSampleRate /= 2.0;
+        maxInput = maxInput / 2 + 1;
+    }
+
+    maxOutputSamples = maxInput;
+    for (auto& buffer : stageBuffers)
+        buffer.setSize(numChannels, maxSamplesPerBlock / 2 + 1, false, true);
+
+    DBG("AnalysisDecimator: " << inputSampleRate << " Hz -> " << outputSampleRate << " Hz in "
+        << static_cast<int>(stages.size()) << " stage(s).");
+}
+
+void AnalysisDecimator::reset()
+{
+    for (auto& stage : stages)
+        stage.reset();
+}
+
+const juce::AudioBuffer<float>& AnalysisDecimator::process(const juce::AudioBuffer<float>& input)
+{
+    if (stages.empty())
+        return input;
+
+    const int numChannels = input.getNumChannels();
+    const float* const* source = input.getArrayOfReadPointers();
+    int numSamples = input.getNumSamples();
+    int target = 0;
+
+    for (auto& stage : stages)
+    {
+        float* const* destination = stageBuffers[target].getArrayOfWritePointers();
+        numSamples = stage.process(source, numChannels, numSamples, destination);
+        source = stageBuffers[target].getArrayOfReadPointers();
+        target = 1 - target;
+    }
+
+    outputView.setDataToReferTo(stageBuffers[1 - target].getArrayOfWritePointers(), numChannels, numSamples);
+    return outputView;
+}
+
+int AnalysisDecimator::skip(int numInputSamples)
+{
+    int numSamples = numInputSamples;
+    for (auto& stage : stages)
+        numSamples = stage.skip(numSamples);
+    return numSamples;
+}
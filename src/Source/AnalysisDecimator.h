@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+//==============================================================================
+/**
+ * Cascade of 2:1 half-band decimators that brings high-rate audio down to the
+ * 44.1/48 kHz family before loudness analysis.
+ *
+ * BS.1770 loudness only depends on the audible band, so at 88.2 kHz and above
+ * the meter can run at a fraction of the rate. Each stage is a Kaiser-windowed
+ * half-band FIR designed at prepare() time for 80 dB of stopband rejection
+ * above (output rate - 20 kHz), with flat response up to 20 kHz. Half of its
+ * taps are zero and the rest are symmetric, so a stage costs about a quarter
+ * of its length in multiply-adds per output sample; the inner loops run over
+ * contiguous memory so the compiler can vectorise them.
+ *
+ * Blocks of any length (including odd ones) are accepted; the decimation phase
+ * carries over between calls.
+ */
+class AnalysisDecimator
+{
+public:
+    static constexpr double minimumOutputRate = 44100.0;  // Stop halving below this
+    static constexpr double passbandEdgeHz = 20000.0;     // Kept flat
+    static constexpr double stopbandAttenuationDb = 80.0;
+
+    /**
+     * Designs the cascade for an input rate. With shouldDecimate false (or a
+     * rate below 88.2 kHz) there are no stages and process() copies through.
+     */
+    void prepare(double inputSampleRate, int numChannels, int maxSamplesPerBlock, bool shouldDecimate);
+
+    /** Clears the filter history and the decimation phase. */
+    void reset();
+
+    /** Overall decimation factor (1, 2, 4 or 8). */
+    int getFactor() const noexcept { return 1 << static_cast<int>(stages.size()); }
+
+    /** Rate of the audio coming out of process(). */
+    double getOutputSampleRate() const noexcept { return outputSampleRate; }
+
+    /** Upper bound on the samples process() returns for a block of the prepared size. */
+    int getMaxOutputSamples() const noexcept { return maxOutputSamples; }
+
+    /**
+     * Decimates a block into the internal output buffer.
+     * @return The decimated audio (a view valid until the next call)
+     */
+    const juce::AudioBuffer<float>& process(const juce::AudioBuffer<float>& input);
+
+    /**
+     * Advances through a block known to be silent without filtering it.
+     * The history is cleared, which is exact for digital silence and within
+     * the meter's silence threshold otherwise.
+     * @return The number of output samples the block would have produced
+     */
+    int skip(int numInputSamples);
+
+private:
+    struct Stage
+    {
+        std::vector<float> oddTaps;                     // h[centre - 1], h[centre - 3], ... (mirrored on the other side)
+        float centreTap = 0.5f;                         // h[centre]
+        int halfLength = 0;                             // Taps either side of the centre
+        std::vector<std::vector<float>> lines;          // Per channel: history followed by the current block
+        int phase = 0;                                  // 0 = next input sample produces an output
+
+        void design(double inputRate);
+        int process(const float* const* input, int numChannels, int numSamples, float* const* output);
+        int skip(int numSamples);
+        void reset();
+    };
+
+    std::vector<Stage> stages;
+    juce::AudioBuffer<float> stageBuffers[2];           // Ping-pong buffers between stages
+    juce::AudioBuffer<float> outputView;                // Points into the last stage's buffer
+    double outputSampleRate = 0.0;
+    int maxOutputSamples = 0;
+
+    static double besselI0(double x);
+};
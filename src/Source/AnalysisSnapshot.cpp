@@ -0,0 +1,60 @@
+#include "AnalysisSnapshot.h"
+
+namespace
+{
+    constexpr int maxSeqlockReadAttempts = 64; // The audio thread publishes once a block, so a retry or two is the norm
+}
+
+//==============================================================================
+bool AnalysisSnapshotPublisher::tryPublish (const AnalysisSnapshot& snapshot) noexcept
+{
+    const juce::SpinLock::ScopedTryLockType lock (writeLock);
+    if (! lock.isLocked())
+        return false;
+
+    write(snapshot);
+    return true;
+}
+
+void AnalysisSnapshotPublisher::write (const AnalysisSnapshot& snapshot) noexcept
+{
+    const auto flagBits = (snapshot.isBypassed ? bypassedFlag : 0u) | (snapshot.isTransportPaused ? pausedFlag : 0u);
+
+    // Seqlock write: odd sequence means an update is in progress.
+    sequence.fetch_add(1, std::memory_order_acq_rel);
+    frame.store(frame.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    peak.store(snapshot.peak, std::memory_order_relaxed);
+    lra.store(snapshot.lra, std::memory_order_relaxed);
+    status.store(static_cast<juce::int32> (snapshot.status), std::memory_order_relaxed);
+    flags.store(flagBits, std::memory_order_relaxed);
+    sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool AnalysisSnapshotPublisher::read (AnalysisSnapshot& result) const noexcept
+{
+    // Seqlock read: retry until we see the same even sequence before and after.
+    for (int attempt = 0; attempt < maxSeqlockReadAttempts; ++attempt)
+    {
+        const auto before = sequence.load(std::memory_order_acquire);
+        if ((before & 1u) != 0)
+            continue;
+
+        AnalysisSnapshot copy;
+        copy.frame = frame.load(std::memory_order_relaxed);
+        copy.peak = peak.load(std::memory_order_relaxed);
+        copy.lra = lra.load(std::memory_order_relaxed);
+        copy.status = static_cast<DynamicsStatus> (status.load(std::memory_order_relaxed));
+        const auto flagBits = flags.load(std::memory_order_relaxed);
+        copy.isBypassed = (flagBits & bypassedFlag) != 0;
+        copy.isTransportPaused = (flagBits & pausedFlag) != 0;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before)
+        {
+            result = copy;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+#include "Constants.h" // For DynamicsStatus, ParameterDefaults
+
+//==============================================================================
+/**
+ * Everything the editor shows from one processBlock, taken together: peak,
+ * reported LRA, status and the bypass and transport flags. Read through
+ * AnalysisSnapshotPublisher the values always belong to the same block, where
+ * separate atomics could pair a new status with the previous block's LRA.
+ */
+struct AnalysisSnapshot
+{
+    juce::uint64 frame = 0;                                 // Snapshots published since construction; 0 = none yet
+    float peak = ParameterDefaults::peak;                   // Block peak in dBFS
+    float lra = ParameterDefaults::lra;                     // Reported LRA in LU
+    DynamicsStatus status = DynamicsStatus::AwaitingAudio;
+    bool isBypassed = false;
+    bool isTransportPaused = false;                         // Measurement frozen while the host transport is stopped
+};
+
+//==============================================================================
+/**
+ * Publishes AnalysisSnapshots with a seqlock, the same scheme SessionRegistry
+ * uses for its slots: an odd sequence means a write is in progress, and a
+ * reader keeps the copy only if it saw the same even sequence before and after.
+ *
+ * The audio thread publishes after every block; the processor also publishes
+ * after a reset or preset change, so the editor sees it even while the host
+ * is not calling processBlock. Parameter changes may arrive on either thread,
+ * so writers take a SpinLock with a try-lock and never wait: a writer that
+ * loses the race skips its snapshot, and the audio thread's next block
+ * publishes the newer state. Readers never block a writer.
+ */
+class AnalysisSnapshotPublisher
+{
+public:
+    /**
+     * Publishes a snapshot. Wait-free and allocation-free; safe to call from
+     * the audio thread. If another thread is publishing at this moment
+     * nothing is written.
+     * @return True if the snapshot was published
+     */
+    bool tryPublish (const AnalysisSnapshot& snapshot) noexcept;
+
+    /**
+     * Copies the latest snapshot; its frame is the number of snapshots
+     * published so far.
+     * @return False, leaving the result untouched, if a consistent copy could
+     *         not be taken (a writer kept racing the reader)
+     */
+    bool read (AnalysisSnapshot& result) const noexcept;
+
+private:
+    void write (const AnalysisSnapshot& snapshot) noexcept;
+
+    juce::SpinLock writeLock;                               // Keeps two writers apart; only ever try-locked
+    std::atomic<juce::uint32> sequence { 0 };               // Seqlock guarding the fields below
+    std::atomic<juce::uint64> frame { 0 };
+    std::atomic<float> peak { ParameterDefaults::peak };
+    std::atomic<float> lra { ParameterDefaults::lra };
+    std::atomic<juce::int32> status { static_cast<juce::int32> (DynamicsStatus::AwaitingAudio) };
+    std::atomic<juce::uint32> flags { 0 };                  // bypassedFlag | pausedFlag
+
+    static constexpr juce::uint32 bypassedFlag = 1;
+    static constexpr juce::uint32 pausedFlag = 2;
+};
@@ -0,0 +1,135 @@
+#include "AnalysisWorkerPool.h"
+
+//==============================================================================
+AnalysisWorkerPool::Worker::Worker (AnalysisWorkerPool& owner, int index)
+    : juce::Thread ("DynamicsDoctor Analysis " + juce::String (index)),
+      pool (owner),
+      workerIndex (index)
+{
+}
+
+void AnalysisWorkerPool::Worker::run()
+{
+    while (! threadShouldExit())
+    {
+        // Keep going while there is work or a client asked for another pass;
+        // otherwise sleep until the next poll
+        const bool didWork = pool.runPendingWork(workerIndex);
+        const bool wakeRequested = pool.wakeRequests[static_cast<size_t>(workerIndex)].exchange(false);
+        if (! didWork && ! wakeRequested)
+            wait(idleWaitMs);
+    }
+}
+
+//==============================================================================
+AnalysisWorkerPool::AnalysisWorkerPool()
+{
+    const int numWorkers = chooseNumWorkers();
+    DBG("AnalysisWorkerPool: Starting " << numWorkers << " worker thread(s).");
+
+    // Create every worker before starting any, as they read the worker count
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new Worker (*this, i));
+
+    for (auto* worker : workers)
+        worker->startThread(juce::Thread::Priority::low);
+}
+
+AnalysisWorkerPool::~AnalysisWorkerPool()
+{
+    // stopThread() also wakes the worker, so this returns within one slice
+    for (auto* worker : workers)
+        worker->stopThread(1000);
+
+    workers.clear();
+}
+
+int AnalysisWorkerPool::chooseNumWorkers()
+{
+    // The host keeps most cores busy with its own audio threads. Analysis is
+    // not deadline-critical, so a quarter of the physical cores is plenty.
+    return juce::jlimit(1, maxWorkers, juce::SystemStats::getNumPhysicalCpus() / 4);
+}
+
+//==============================================================================
+int AnalysisWorkerPool::registerClient (AnalysisClient& client)
+{
+    for (int i = 0; i < maxClients; ++i)
+    {
+        AnalysisClient* expected = nullptr;
+        if (slots[i].client.compare_exchange_strong(expected, &client))
+            return i;
+    }
+
+    DBG("AnalysisWorkerPool::registerClient - No free slot.");
+    return -1;
+}
+
+void AnalysisWorkerPool::unregisterClient (int handle)
+{
+    if (! juce::isPositiveAndBelow(handle, maxClients))
+        return;
+
+    auto& slot = slots[handle];
+    slot.client.store(nullptr);
+
+    // A worker that picked up the pointer before the store may still be inside it
+    while (slot.activeUsers.load() != 0)
+        juce::Thread::yield();
+}
+
+void AnalysisWorkerPool::notifyWorkAvailable (int handle) noexcept
+{
+    // No Thread::notify() here: it takes a lock, and this is called from audio threads
+    if (juce::isPositiveAndBelow(handle, maxClients) && ! workers.isEmpty())
+        wakeRequests[static_cast<size_t>(handle % workers.size())].store(true, std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool AnalysisWorkerPool::serviceSlot (int slotIndex, bool highPriorityPass)
+{
+    auto& slot = slots[slotIndex];
+
+    // Announce ourselves before reading the pointer, so unregisterClient() can wait for us
+    slot.activeUsers.fetch_add(1);
+
+    bool didWork = false;
+    if (auto* client = slot.client.load())
+    {
+        if (client->isAnalysisHighPriority() == highPriorityPass && client->hasPendingAnalysis())
+        {
+            // A slice that found the instance busy made no progress, so the worker may sleep
+            didWork = client->runAnalysisSlice();
+        }
+    }
+
+    slot.activeUsers.fetch_sub(1);
+    return didWork;
+}
+
+bool AnalysisWorkerPool::runPendingWork (int workerIndex)
+{
+    const int numWorkers = workers.size();
+    bool didWork = false;
+
+    for (const bool highPriorityPass : { true, false })
+    {
+        // Own slots first...
+        for (int i = workerIndex; i < maxClients; i += numWorkers)
+            didWork = serviceSlot(i, highPriorityPass) || didWork;
+
+        // ...then steal from the other workers' slots
+        if (! didWork)
+        {
+            for (int i = 0; i < maxClients; ++i)
+                if (i % numWorkers != workerIndex)
+                    didWork = serviceSlot(i, highPriorityPass) || didWork;
+        }
+
+        // Don't start on background clients while visible ones may still have work
+        if (didWork)
+            break;
+    }
+
+    return didWork;
+}
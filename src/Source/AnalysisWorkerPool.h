@@ -0,0 +1,114 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+ * Interface for an instance whose loudness analysis runs on the shared pool.
+ *
+ * The pool calls runAnalysisSlice() from one of its worker threads whenever
+ * hasPendingAnalysis() reports work. A slice must do a bounded amount of work
+ * and must tolerate being called from different worker threads over time.
+ */
+class AnalysisClient
+{
+public:
+    virtual ~AnalysisClient() = default;
+
+    /**
+     * Performs a bounded chunk of pending analysis.
+     * @return true if more work is ready after this slice; false if the slice
+     *         drained the queue or could not run (another thread holds the instance)
+     */
+    virtual bool runAnalysisSlice() = 0;
+
+    /** True if there is queued audio or a pending reset to handle. */
+    virtual bool hasPendingAnalysis() const noexcept = 0;
+
+    /** True if the instance should be served first (e.g. its editor is showing). */
+    virtual bool isAnalysisHighPriority() const noexcept = 0;
+};
+
+//==============================================================================
+/**
+ * Process-wide pool of low-priority analysis threads shared by every
+ * DynamicsDoctor instance (through juce::SharedResourcePointer).
+ *
+ * Each client is registered in a fixed, lock-free slot table. Slots are
+ * homed on workers round-robin; a worker serves its own clients first and
+ * steals from the other workers' slots when it runs dry. Clients with a
+ * visible editor are served before the rest on every pass.
+ *
+ * Workers sleep with a short timeout, so the number of wake-ups depends on
+ * the worker count rather than the instance count. A wake-up request from an
+ * audio thread only raises a flag; the worker picks it up within one poll. The
+ * thread count is capped to a quarter of the physical cores, leaving the
+ * rest to the host's own audio threads.
+ */
+class AnalysisWorkerPool
+{
+public:
+    static constexpr int maxClients = 256;          // Instances served by one pool
+    static constexpr int maxWorkers = 4;            // Upper bound on worker threads
+    static constexpr int idleWaitMs = 10;           // Polling interval of an idle worker
+
+    AnalysisWorkerPool();
+    ~AnalysisWorkerPool();
+
+    /**
+     * Adds a client to the pool. Call from the message thread.
+     * @return A handle for the other calls, or -1 if the pool is full
+     */
+    int registerClient (AnalysisClient& client);
+
+    /**
+     * Removes a client. Blocks until no worker is inside the client any more,
+     * so the client can be destroyed as soon as this returns.
+     */
+    void unregisterClient (int handle);
+
+    /**
+     * Asks the worker that owns this client's slot to go round again without
+     * sleeping. Lock-free and wait-free (one atomic store), so it is safe on
+     * the audio thread; a sleeping worker sees it within idleWaitMs.
+     */
+    void notifyWorkAvailable (int handle) noexcept;
+
+    /** Number of worker threads in the pool. */
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+private:
+    //==============================================================================
+    struct ClientSlot
+    {
+        std::atomic<AnalysisClient*> client { nullptr };
+        std::atomic<int> activeUsers { 0 };          // Workers currently inside this slot
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker (AnalysisWorkerPool& owner, int index);
+        void run() override;
+
+    private:
+        AnalysisWorkerPool& pool;
+        const int workerIndex;
+    };
+
+    /** One scheduling pass for a worker. Returns true if any slice was run. */
+    bool runPendingWork (int workerIndex);
+
+    /** Runs one slice of the client in a slot if it has work at the given priority. */
+    bool serviceSlot (int slotIndex, bool highPriorityPass);
+
+    static int chooseNumWorkers();
+
+    std::array<ClientSlot, maxClients> slots;
+    juce::OwnedArray<Worker> workers;
+    std::array<std::atomic<bool>, maxWorkers> wakeRequests {}; // Raised by notifyWorkAvailable, per worker
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisWorkerPool)
+};
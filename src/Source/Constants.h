@@ -58,18 +58,48 @@ struct DynamicsPreset
     float lraThresholdAmber;  // Amber light threshold
     float targetLraMin;       // Minimum target LRA
     float targetLraMax;       // Maximum target LRA
+
+    // Status steadiness (see StatusFilter)
+    float hysteresisLU = 0.3f;      // LRA must cross a threshold by this much to change status
+    double minDwellSeconds = 5.0;   // A shown status is kept for at least this long
+
+    // Over-limiting warnings in dB (see MicroDynamicsTracker); 0 = not checked
+    float minPSR = 0.0f;            // Lowest acceptable peak-to-short-term loudness ratio
+    float minPLR = 0.0f;            // Lowest acceptable peak-to-loudness ratio
 };
 
 //==============================================================================
 /**
- * Predefined dynamic range presets for different music genres.
+ * Built-in dynamic range presets for different music genres.
  * Each preset defines specific LRA thresholds and target ranges.
+ * User presets are appended by PresetRegistry; read presets through it.
+ */
+const std::vector<DynamicsPreset> builtInPresets = {
+    // id,         label,            red,    amber,  min,    max,   hysteresis, dwell, PSR,   PLR
+    { "edm",       "EDM/Club",       3.0f,   3.6f,   3.0f,   8.0f,  0.2f,       5.0,  5.0f,  6.0f },
+    { "pop_rock",  "Pop/Rock",       4.0f,   4.8f,   4.0f,   9.0f,  0.3f,       5.0,  6.0f,  8.0f },
+    { "classical", "Classical",      6.0f,   7.2f,   6.0f,  22.0f,  0.5f,      10.0, 10.0f, 14.0f }
+};
+
+//==============================================================================
+/**
+ * Choices for how often LRA and the status are re-evaluated, from live
+ * feedback while mixing down to background monitoring of large sessions.
  */
-const std::vector<DynamicsPreset> presets = {
-    // id,         label,            red,    amber,  min,    max
-    { "edm",       "EDM/Club",       3.0f,   3.6f,   3.0f,   8.0f },
-    { "pop_rock",  "Pop/Rock",       4.0f,   4.8f,   4.0f,   9.0f },
-    { "classical", "Classical",      6.0f,   7.2f,   6.0f,  22.0f }
+struct LraRateOption
+{
+    juce::String label;       // Display name in the editor and host
+    double hz;                // Evaluations per second
+};
+
+const std::vector<LraRateOption> lraRates = {
+    { "10 Hz (live)",       10.0 },
+    { "5 Hz",                5.0 },
+    { "2 Hz",                2.0 },
+    { "1 Hz",                1.0 },
+    { "0.5 Hz",              0.5 },
+    { "0.2 Hz",              0.2 },
+    { "0.1 Hz (background)", 0.1 }
 };
 
 //==============================================================================
@@ -83,6 +113,15 @@ namespace ParameterIDs
     const juce::ParameterID peak     { "peak",   1 };
     const juce::ParameterID lra      { "lra",    1 };
     const juce::ParameterID resetLra { "resetLra", 1 };
+    const juce::ParameterID lraRate  { "lraRate", 1 };
+    const juce::ParameterID highRateDecimation { "highRateDecimation", 1 };
+    const juce::ParameterID timelineAligned { "timelineAligned", 1 };
+    const juce::ParameterID pauseWithTransport { "pauseWithTransport", 1 };
+    const juce::ParameterID bandAnalysis { "bandAnalysis", 1 };
+    const juce::ParameterID exposureStandard { "exposureStandard", 1 };
+    const juce::ParameterID monitorCalibration { "monitorCalibration", 1 };
+    const juce::ParameterID saveMeasurement { "saveMeasurement", 1 };
+    const juce::ParameterID meterOutput { "meterOutput", 1 };
 }
 
 //==============================================================================
@@ -95,6 +134,15 @@ namespace ParameterDefaults
     const int  preset = 1;                    // Default to Pop/Rock preset
     const float peak = -100.0f;               // Initial peak level
     const float lra = 0.0f;                   // Initial LRA value
+    const int  lraRate = 3;                   // Default to one LRA evaluation per second
+    const bool highRateDecimation = true;     // Analyse 88.2 kHz and above at 44.1/48 kHz
+    const bool timelineAligned = false;       // Key loudness to the host timeline instead of wall-clock blocks
+    const bool pauseWithTransport = true;     // Freeze the measurement while the host transport is stopped
+    const bool bandAnalysis = false;          // Per-band loudness and LRA (four bands)
+    const int  exposureStandard = 0;          // Listening dose against NIOSH (see ExposureDose)
+    const float monitorCalibration = 80.0f;   // dB SPL at the listening position for a -20 LUFS programme
+    const bool saveMeasurement = true;        // Keep the LRA history in the saved plugin state
+    const bool meterOutput = false;           // Send peak and LRA to the host as meter parameters
     constexpr float LRA_MEASURING_DURATION = 6.0f; // LRA measurement period
 }
 
@@ -131,6 +179,18 @@ inline juce::String getStatusMessage(DynamicsStatus status)
     }
 }
 
+//==============================================================================
+/**
+ * Folder for files the plugin writes on request (timing and session reports).
+ * Created on first use inside the user's documents folder.
+ */
+inline juce::File getReportDirectory()
+{
+    auto directory = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("DynamicsDoctor");
+    directory.createDirectory();
+    return directory;
+}
+
 //==============================================================================
 /**
  * Traffic light display configuration and utilities.
@@ -145,6 +205,7 @@ namespace TrafficLightMetrics
     constexpr float ActiveBorderDarkenFactor = 0.5f;
     constexpr float InactiveBackgroundBrightnessFactor = 0.2f;
     constexpr float BypassedBorderDarkenFactor = 0.3f;
+    constexpr float TentativeAlpha = 0.45f;   // Light for a provisional verdict while measuring
 
     /**
      * Determines the color of a traffic light based on current plugin state.
@@ -0,0 +1,236 @@
+#include "EventJournal.h"
+#include <algorithm> // For std::sort
+
+//==============================================================================
+EventLogWriter::EventLogWriter()
+    : juce::Thread ("DynamicsDoctor event logs")
+{
+    startThread(juce::Thread::Priority::background);
+}
+
+EventLogWriter::~EventLogWriter()
+{
+    stopThread(2000);
+    writePending(); // The last journals flushed on their way out
+}
+
+void EventLogWriter::append (const juce::File& file, const juce::String& text)
+{
+    const juce::ScopedLock sl (pendingLock);
+    pendingFiles.add(file);
+    pendingText.add(text);
+}
+
+juce::File EventLogWriter::getDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("DynamicsDoctor")
+               .getChildFile("Event Logs");
+}
+
+void EventLogWriter::run()
+{
+    // Logs from sessions long gone
+    applyRetention(juce::Time::currentTimeMillis() - static_cast<juce::int64>(retentionDays) * 24 * 60 * 60 * 1000);
+
+    while (! threadShouldExit())
+    {
+        wait(flushIntervalMs);
+        writePending();
+    }
+}
+
+void EventLogWriter::writePending()
+{
+    juce::Array<juce::File> files;
+    juce::StringArray text;
+    {
+        const juce::ScopedLock sl (pendingLock);
+        files.swapWith(pendingFiles);
+        text.swapWith(pendingText);
+    }
+
+    bool createdLog = false;
+    for (int i = 0; i < files.size(); ++i)
+    {
+        const auto& file = files.getReference(i);
+        if (! file.existsAsFile())
+        {
+            file.getParentDirectory().createDirectory();
+            createdLog = true;
+        }
+
+        if (! file.appendText(text[i]))
+            DBG("EventLogWriter: Could not write " << file.getFullPathName());
+    }
+
+    if (createdLog)
+        applyRetention(0);
+}
+
+void EventLogWriter::applyRetention (juce::int64 cutoffMs)
+{
+    auto logs = getDirectory().findChildFiles(juce::File::findFiles, false, "*.csv");
+
+    // Newest first, so everything past maxLogFiles is the oldest
+    std::sort(logs.begin(), logs.end(), [] (const juce::File& a, const juce::File& b)
+    {
+        return a.getLastModificationTime() > b.getLastModificationTime();
+    });
+
+    for (int i = 0; i < logs.size(); ++i)
+        if (i >= maxLogFiles || logs.getReference(i).getLastModificationTime().toMilliseconds() < cutoffMs)
+            logs.getReference(i).deleteFile();
+}
+
+//==============================================================================
+EventJournal::EventJournal (const PresetRegistry& presets)
+    : presetRegistry (presets)
+{
+    startTimer(drainIntervalMs);
+}
+
+EventJournal::~EventJournal()
+{
+    stopTimer();
+    drain(); // Hand the last events to the log writer
+}
+
+//==============================================================================
+void EventJournal::record (Type type, juce::int64 samplePosition, float lra, int from, int to) noexcept
+{
+    const auto position = writePosition.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = slots[static_cast<size_t>(position & (capacity - 1))];
+
+    // Seqlock write: an odd sequence tells the reader the slot is changing
+    slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.type.store(static_cast<juce::int32>(type), std::memory_order_relaxed);
+    slot.samplePosition.store(samplePosition, std::memory_order_relaxed);
+    slot.wallTimeMs.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+    slot.lra.store(lra, std::memory_order_relaxed);
+    slot.from.store(from, std::memory_order_relaxed);
+    slot.to.store(to, std::memory_order_relaxed);
+    slot.sequence.store(2 * position + 2, std::memory_order_release);
+}
+
+bool EventJournal::readSlot (juce::uint64 position, Event& event) const noexcept
+{
+    const auto& slot = slots[static_cast<size_t>(position & (capacity - 1))];
+    const auto expected = 2 * position + 2;
+
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+        return false;
+
+    event.type = static_cast<Type>(slot.type.load(std::memory_order_relaxed));
+    event.samplePosition = slot.samplePosition.load(std::memory_order_relaxed);
+    event.wallTimeMs = slot.wallTimeMs.load(std::memory_order_relaxed);
+    event.lra = slot.lra.load(std::memory_order_relaxed);
+    event.from = slot.from.load(std::memory_order_relaxed);
+    event.to = slot.to.load(std::memory_order_relaxed);
+
+    // Still the same write? Otherwise a producer a full lap ahead got there first
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+//==============================================================================
+void EventJournal::drain()
+{
+    juce::String csv;
+    bool addedEvents = false;
+
+    for (;;)
+    {
+        const auto written = writePosition.load(std::memory_order_acquire);
+        if (readPosition == written)
+            break;
+
+        // Producers lapped the reader: everything older than one ring is gone
+        if (written - readPosition > static_cast<juce::uint64>(capacity))
+        {
+            numDropped += written - capacity - readPosition;
+            readPosition = written - capacity;
+        }
+
+        Event event;
+        if (! readSlot(readPosition, event))
+        {
+            const auto sequence = slots[static_cast<size_t>(readPosition & (capacity - 1))].sequence.load(std::memory_order_acquire);
+            if (sequence < 2 * readPosition + 2)
+                break; // Claimed but not finished yet; pick it up next time
+
+            ++numDropped; // Overwritten while we looked at it
+            ++readPosition;
+            continue;
+        }
+
+        ++readPosition;
+        history.push_back(event);
+        if (static_cast<int>(history.size()) > maxHistory)
+            history.pop_front();
+
+        csv << juce::Time(event.wallTimeMs).formatted("%Y-%m-%d %H:%M:%S") << ","
+            << event.samplePosition << ","
+            << juce::String(event.lra, 1) << ","
+            << describe(event).quoted() << "\n";
+        addedEvents = true;
+    }
+
+    if (! addedEvents)
+        return;
+
+    ++historyVersion;
+
+    // Named without touching the disk: the time, and a random part for instances started together
+    if (logFile == juce::File())
+    {
+        logFile = EventLogWriter::getDirectory().getChildFile("Events " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S")
+                                                              + " " + juce::Uuid().toString().substring(0, 8) + ".csv");
+        csv = "wall_time,sample_position,lra,event\n" + csv;
+    }
+
+    logWriter->append(logFile, csv);
+}
+
+//==============================================================================
+juce::String EventJournal::describe (const Event& event) const
+{
+    switch (event.type)
+    {
+        case Type::StatusChanged:
+            return "Status " + getStatusMessage(static_cast<DynamicsStatus>(event.from))
+                 + " -> " + getStatusMessage(static_cast<DynamicsStatus>(event.to));
+        case Type::Reset:
+            return "LRA measurement reset";
+        case Type::Bypass:
+            return event.to != 0 ? "Bypassed" : "Bypass off";
+        case Type::Transport:
+            return event.to != 0 ? "Transport stopped, measurement paused" : "Transport playing, measurement resumed";
+        case Type::Render:
+            return event.to != 0 ? "Offline render started" : "Offline render finished";
+        case Type::PresetChanged:
+            return "Preset " + presetRegistry.getLabel(event.from) + " -> " + presetRegistry.getLabel(event.to);
+        default:
+            return "Unknown event";
+    }
+}
+
+juce::String EventJournal::createReport() const
+{
+    const double rate = sampleRate.load();
+    juce::String report;
+    report << "Events (" << static_cast<int>(history.size()) << " kept, "
+           << juce::String(static_cast<juce::int64>(numDropped)) << " dropped)\n";
+
+    for (const auto& event : history)
+    {
+        report << "  " << juce::Time(event.wallTimeMs).formatted("%H:%M:%S")
+               << "  sample " << event.samplePosition;
+        if (rate > 0.0)
+            report << " (" << juce::String(static_cast<double>(event.samplePosition) / rate, 3) << " s)";
+        report << "  LRA " << juce::String(event.lra, 1) << " LU  " << describe(event) << "\n";
+    }
+
+    return report;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <deque>
+
+#include "Constants.h"      // For DynamicsStatus
+#include "PresetRegistry.h" // For preset labels in descriptions
+
+//==============================================================================
+/**
+ * Process-wide low-priority thread that appends the journals' CSV lines to
+ * their log files (through juce::SharedResourcePointer), so the message
+ * thread never touches the disk for them. It also keeps the log directory in
+ * bounds: logs older than retentionDays are deleted at start-up, and each new
+ * log file pushes out the oldest ones beyond maxLogFiles.
+ */
+class EventLogWriter : private juce::Thread
+{
+public:
+    static constexpr int flushIntervalMs = 2000;    // Appends are batched this long at most
+    static constexpr int retentionDays = 30;        // Older logs are deleted at start-up
+    static constexpr int maxLogFiles = 200;         // Newest logs kept in the directory
+
+    EventLogWriter();
+    ~EventLogWriter() override;
+
+    /** Queues text to be appended to a log file. Never waits for the disk. */
+    void append (const juce::File& file, const juce::String& text);
+
+    /** <user application data>/DynamicsDoctor/Event Logs */
+    static juce::File getDirectory();
+
+private:
+    void run() override;
+
+    /** Appends everything queued so far. Writer thread (or the destructor once it has stopped). */
+    void writePending();
+
+    /** Deletes logs past the age limit (if given) and beyond the newest maxLogFiles. */
+    static void applyRetention (juce::int64 cutoffMs);
+
+    juce::CriticalSection pendingLock;              // Held only to swap the queue
+    juce::Array<juce::File> pendingFiles;
+    juce::StringArray pendingText;                  // One entry per pendingFiles entry
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventLogWriter)
+};
+
+//==============================================================================
+/**
+ * Record of what the plugin did and when: status transitions, resets, bypass
+ * and preset changes, each stamped with the sample position of the audio
+ * block it happened in, the wall clock time and the LRA at that moment.
+ *
+ * record() is wait-free and allocation-free, and may be called from the audio
+ * thread and the message thread at the same time. Events go into a fixed ring
+ * of seqlocked slots; when the ring is full the oldest undrained events are
+ * overwritten and counted as dropped.
+ *
+ * A timer on the message thread drains the ring into a history kept for the
+ * editor and the session report, and hands each event to the shared
+ * EventLogWriter, which appends it to a CSV log in the background.
+ */
+class EventJournal : private juce::Timer
+{
+public:
+    static constexpr int capacity = 1024;           // Ring slots (power of two)
+    static constexpr int maxHistory = 2048;         // Drained events kept in memory
+    static constexpr int drainIntervalMs = 250;
+
+    enum class Type : juce::int32
+    {
+        StatusChanged,  // from/to: DynamicsStatus
+        Reset,          // LRA measurement restarted
+        Bypass,         // to: 1 = bypassed, 0 = active again
+        PresetChanged,  // from/to: preset indices
+        Transport,      // to: 1 = paused by the host transport, 0 = resumed
+        Render          // to: 1 = offline render started, 0 = finished
+    };
+
+    struct Event
+    {
+        Type type = Type::Reset;
+        juce::int64 samplePosition = 0;             // Start of the audio block, on the processor's sample clock
+        juce::int64 wallTimeMs = 0;
+        float lra = 0.0f;
+        juce::int32 from = 0;
+        juce::int32 to = 0;
+    };
+
+    explicit EventJournal (const PresetRegistry& presets);
+    ~EventJournal() override;
+
+    /** Adds an event (the wall time is filled in here). Wait-free; any thread. */
+    void record (Type type, juce::int64 samplePosition, float lra, int from = 0, int to = 0) noexcept;
+
+    /** Rate used to show sample positions as seconds. */
+    void setSampleRate (double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+
+    //==============================================================================
+    // Message thread only
+
+    /** Moves everything recorded so far into the history and the log file. */
+    void drain();
+
+    const std::deque<Event>& getHistory() const noexcept { return history; }
+
+    /** Incremented by every drain that found events; lets views skip unchanged histories. */
+    juce::uint32 getHistoryVersion() const noexcept { return historyVersion; }
+
+    /** Events overwritten before they could be drained. */
+    juce::uint64 getNumDropped() const noexcept { return numDropped; }
+
+    /** One line of plain text for an event. */
+    juce::String describe (const Event& event) const;
+
+    /** The whole history as a report section. */
+    juce::String createReport() const;
+
+    /** The CSV file of this instance (named with the first event, written in the background). */
+    const juce::File& getLogFile() const noexcept { return logFile; }
+
+private:
+    void timerCallback() override { drain(); }
+    bool readSlot (juce::uint64 position, Event& event) const noexcept;
+
+    /** Every field is an atomic so concurrent overwrites are well defined. */
+    struct Slot
+    {
+        std::atomic<juce::uint64> sequence { 0 };   // 2 * position + 1 while writing, 2 * position + 2 when written
+        std::atomic<juce::int32> type { 0 };
+        std::atomic<juce::int64> samplePosition { 0 };
+        std::atomic<juce::int64> wallTimeMs { 0 };
+        std::atomic<float> lra { 0.0f };
+        std::atomic<juce::int32> from { 0 };
+        std::atomic<juce::int32> to { 0 };
+    };
+
+    std::array<Slot, capacity> slots;
+    std::atomic<juce::uint64> writePosition { 0 };  // Next position to claim
+    std::atomic<double> sampleRate { 0.0 };
+
+    const PresetRegistry& presetRegistry;
+    juce::SharedResourcePointer<EventLogWriter> logWriter;
+    juce::uint64 readPosition = 0;                  // Message thread only from here on
+    juce::uint64 numDropped = 0;
+    std::deque<Event> history;
+    juce::uint32 historyVersion = 0;
+    juce::File logFile;
+
+    static_assert ((capacity & (capacity - 1)) == 0, "Capacity must be a power of two");
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EventJournal)
+};
@@ -0,0 +1,159 @@
+#include "ExposureDose.h"
+#include <cmath> // For std::pow, std::log10
+
+namespace
+{
+    constexpr juce::int64 msPerDay = 24 * 60 * 60 * 1000;
+
+    // The calibration is given at -20 LUFS; the stored energy is relative to 0 LUFS
+    double getSplAtZeroLufs (float splAtMinus20Lufs) { return static_cast<double>(splAtMinus20Lufs) + 20.0; }
+
+    const std::array<ExposureDose::Standard, ExposureDose::numStandards> standards
+    {{
+        { "NIOSH (85 dB, 8 h a day)",  85.0f, 8.0f,  1 },
+        { "WHO (80 dB, 40 h a week)",  80.0f, 40.0f, 7 }
+    }};
+}
+
+const juce::Identifier ExposureDose::stateType { "Exposure" };
+
+const ExposureDose::Standard& ExposureDose::getStandard (int index)
+{
+    return standards[static_cast<size_t>(juce::jlimit(0, numStandards - 1, index))];
+}
+
+//==============================================================================
+juce::String ExposureDose::Reading::describe (const Standard& standard) const
+{
+    juce::String text;
+    text << "Listening dose: " << juce::String(dosePercent, 0) << " % of " << standard.label << "\n";
+
+    if (listeningHours <= 0.0)
+        return text + "Nothing measured today";
+
+    text << "Today: " << juce::String(listeningHours, 1) << " h at " << juce::String(equivalentLevelDb, 1) << " dB SPL (Leq)\n";
+    if (dosePercent >= 100.0)
+        text << "Allowance used up";
+    else
+        text << juce::String(hoursRemaining, 1) << " h left at that level";
+    return text;
+}
+
+//==============================================================================
+ExposureDose::ExposureDose()
+    : utcOffsetMs (static_cast<juce::int64>(juce::Time::getCurrentTime().getUTCOffsetSeconds()) * 1000)
+{
+}
+
+int ExposureDose::getToday() const noexcept
+{
+    return static_cast<int>((juce::Time::currentTimeMillis() + utcOffsetMs) / msPerDay);
+}
+
+void ExposureDose::addSeconds (double energySeconds, int numSeconds)
+{
+    if (numSeconds <= 0)
+        return;
+
+    const int today = getToday();
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    auto& day = days[static_cast<size_t>(today % daysKept)];
+    if (day.dayNumber != today)
+        day = { today, 0.0, 0.0 };  // The slot held a day that has dropped out of the week
+
+    day.energySeconds += energySeconds;
+    day.seconds += numSeconds;
+}
+
+ExposureDose::Reading ExposureDose::getReading (int standardIndex, float splAtMinus20Lufs) const
+{
+    const auto& standard = getStandard(standardIndex);
+    const int today = getToday();
+
+    double energy = 0.0, todayEnergy = 0.0, todaySeconds = 0.0;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        for (const auto& day : days)
+        {
+            if (day.dayNumber < 0 || day.dayNumber > today || day.dayNumber <= today - standard.numDays)
+                continue;
+
+            energy += day.energySeconds;
+            if (day.dayNumber == today)
+            {
+                todayEnergy = day.energySeconds;
+                todaySeconds = day.seconds;
+            }
+        }
+    }
+
+    // Equal energy: the allowance is the criterion level for the criterion time
+    const double gain = std::pow(10.0, (getSplAtZeroLufs(splAtMinus20Lufs) - standard.criterionDb) / 10.0);
+    const double allowanceSeconds = standard.criterionHours * 3600.0;
+
+    Reading reading;
+    reading.dosePercent = 100.0 * energy * gain / allowanceSeconds;
+    reading.listeningHours = todaySeconds / 3600.0;
+
+    if (todaySeconds > 0.0 && todayEnergy > 0.0)
+    {
+        reading.equivalentLevelDb = 10.0 * std::log10(todayEnergy / todaySeconds) + getSplAtZeroLufs(splAtMinus20Lufs);
+        const double doseRatePerSecond = 100.0 * (todayEnergy / todaySeconds) * gain / allowanceSeconds;
+        reading.hoursRemaining = juce::jmax(0.0, (100.0 - reading.dosePercent) / doseRatePerSecond / 3600.0);
+    }
+
+    return reading;
+}
+
+void ExposureDose::clear()
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    days.fill({});
+}
+
+//==============================================================================
+juce::ValueTree ExposureDose::toValueTree() const
+{
+    juce::ValueTree tree (stateType);
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    for (const auto& day : days)
+    {
+        if (day.dayNumber < 0)
+            continue;
+
+        juce::ValueTree child ("Day");
+        child.setProperty("number", day.dayNumber, nullptr);
+        child.setProperty("energy", day.energySeconds, nullptr);
+        child.setProperty("seconds", day.seconds, nullptr);
+        tree.appendChild(child, nullptr);
+    }
+
+    return tree;
+}
+
+void ExposureDose::restore (const juce::ValueTree& tree)
+{
+    if (! tree.hasType(stateType))
+        return;
+
+    const int today = getToday();
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    for (int i = 0; i < tree.getNumChildren(); ++i)
+    {
+        const auto child = tree.getChild(i);
+        const int number = child.getProperty("number", -1);
+        if (number < 0 || number > today || number <= today - daysKept)
+            continue;
+
+        // The same project may be reloaded into an instance that has been measuring: keep the larger count
+        auto& day = days[static_cast<size_t>(number % daysKept)];
+        if (day.dayNumber != number)
+            day = { number, 0.0, 0.0 };
+
+        day.energySeconds = juce::jmax(day.energySeconds, static_cast<double>(child.getProperty("energy", 0.0)));
+        day.seconds = juce::jmax(day.seconds, static_cast<double>(child.getProperty("seconds", 0.0)));
+    }
+}
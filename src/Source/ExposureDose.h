@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <array>
+
+//==============================================================================
+/**
+ * Listening dose over the working day (or week), in the style of the NIOSH
+ * and WHO safe-listening limits: the share of the allowed sound energy that
+ * the monitored programme has used up.
+ *
+ * The meter hands over one K-weighted energy value per second of programme
+ * (libebur128's 1 s window as 10^(LUFS/10), i.e. relative to 0 LUFS), so each
+ * update is O(1) whatever the session length. Energy is kept per calendar day
+ * for the last daysKept days and converted to dB SPL only when a reading is
+ * taken, with the monitor calibration of that moment: changing the calibration
+ * or the standard re-rates the whole history.
+ *
+ * Both standards use the equal-energy rule (3 dB exchange rate). K-weighting
+ * stands in for A-weighting, which is close for programme material but reads
+ * a little high on bass-heavy mixes. Only audio that reaches the plugin is
+ * counted; time spent bypassed or in long silences is not.
+ *
+ * addSeconds() is called by the analysis side, everything else from the
+ * message thread; a SpinLock keeps the two apart for a few dozen instructions.
+ */
+class ExposureDose
+{
+public:
+    static constexpr int daysKept = 7;
+
+    /** Exposure limit: criterionDb for criterionHours over the last numDays days. */
+    struct Standard
+    {
+        const char* label;
+        float criterionDb;
+        float criterionHours;
+        int numDays;
+    };
+
+    static constexpr int numStandards = 2;
+    static const Standard& getStandard (int index);
+
+    /** Dose against one standard, with the equivalent level of today's listening. */
+    struct Reading
+    {
+        double dosePercent = 0.0;                           // Share of the allowance used
+        double equivalentLevelDb = 0.0;                     // Leq of today's listening, dB SPL (0 if none)
+        double listeningHours = 0.0;                        // Programme time today
+        double hoursRemaining = 0.0;                        // Until 100 % at today's Leq (0 if none)
+
+        /** Dose, Leq and time left, one per line. */
+        juce::String describe (const Standard& standard) const;
+    };
+
+    ExposureDose();
+
+    /** Adds measured seconds of programme with their summed energy, relative to 0 LUFS. */
+    void addSeconds (double energySeconds, int numSeconds);
+
+    /** Dose against a standard, with the monitor level (dB SPL) that a -20 LUFS programme plays at. */
+    Reading getReading (int standardIndex, float splAtMinus20Lufs) const;
+
+    /** Forgets every day. */
+    void clear();
+
+    /** Saved with the plugin state so that reloading a project keeps the day's dose. */
+    static const juce::Identifier stateType;
+    juce::ValueTree toValueTree() const;
+
+    /** Merges saved days in (the larger value of each day wins); days older than daysKept are dropped. */
+    void restore (const juce::ValueTree& tree);
+
+private:
+    struct Day
+    {
+        int dayNumber = -1;                                 // Local days since 1970, -1 = unused
+        double energySeconds = 0.0;
+        double seconds = 0.0;
+    };
+
+    /** Today as a local day number, from the wall clock and the cached UTC offset. */
+    int getToday() const noexcept;
+
+    std::array<Day, daysKept> days;                         // Indexed by dayNumber % daysKept
+    juce::int64 utcOffsetMs = 0;                            // Taken at construction; a DST change moves midnight by an hour
+    mutable juce::SpinLock lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ExposureDose)
+};
@@ -3,6 +3,8 @@
 // #include <juce_core/logging/juce_Logger.h>  // For DBG
 #include <limits> // For std::numeric_limits
 #include <vector> // Added for std::vector
+#include <algorithm> // For std::fill
+#include <cmath> // For std::isnan, std::ceil, std::pow
 
 //==============================================================================
 LoudnessMeter::LoudnessMeter()
@@ -20,7 +22,7 @@ LoudnessMeter::~LoudnessMeter()
 }
 
 //==============================================================================
-void LoudnessMeter::prepare(double sampleRate, int numChannels, int /*maxSamplesPerBlock*/)
+void LoudnessMeter::prepare(double sampleRate, int numChannels, int maxSamplesPerBlock)
 {
     // Clean up existing state if present
     if (state != nullptr)
@@ -31,15 +33,43 @@ void LoudnessMeter::prepare(double sampleRate, int numChannels, int /*maxSamples
 
     currentSampleRate = sampleRate;
     currentNumChannels = numChannels;
+    maxInputBlockSize = juce::jmax(1, maxSamplesPerBlock);
+
+    // Everything below runs at the decimated rate
+    decimator.prepare(sampleRate, numChannels, maxInputBlockSize, decimationEnabled);
+    const double meterRate = decimator.getOutputSampleRate();
+
+    // Pre-size the interleave buffer so typical blocks don't allocate
+    tempInterleaveBuffer.resize(static_cast<size_t>(decimator.getMaxOutputSamples() * numChannels));
+
+    // Silence fast path: a fresh state has no filter history to flush
+    gatingHopSamples = juce::jmax(1, juce::roundToInt(meterRate / 10.0));
+    silenceFlushSamples = static_cast<juce::int64>(meterRate * SILENCE_FLUSH_SECONDS);
+    consecutiveSilentSamples = 0;
+    skippedSilentSamples = 0;
+
+    // Timeline slots are allocated here so keying a value never allocates
+    if (timelineAligned)
+        timelineValues.assign(static_cast<size_t>(std::ceil(MAX_TIMELINE_SECONDS * meterRate / gatingHopSamples)),
+                              std::numeric_limits<float>::quiet_NaN());
+    else
+        timelineValues.clear();
+
+    // Bands are appended like the broadband values, so they can't follow the timeline
+    multibandActive = multibandEnabled && ! timelineAligned;
+    if (multibandActive)
+        multiband.prepare(meterRate, numChannels);
 
     // Configure libebur128 with required measurement modes:
     // - EBUR128_MODE_S: Short-term loudness (3-second window)
     // - EBUR128_MODE_M: Momentary loudness (400ms window)
-    // - EBUR128_MODE_LRA: Loudness Range measurement
-    unsigned int mode = EBUR128_MODE_S | EBUR128_MODE_M | EBUR128_MODE_LRA;
+    // - EBUR128_MODE_I + HISTOGRAM: Integrated loudness for PLR, in constant memory
+    // Loudness Range is computed by lraHistogram from the short-term values,
+    // so libebur128's own (ever-growing) LRA block list is not needed.
+    unsigned int mode = EBUR128_MODE_S | EBUR128_MODE_M | EBUR128_MODE_I | EBUR128_MODE_HISTOGRAM;
 
     state = ebur128_init(static_cast<unsigned>(numChannels),
-                        static_cast<unsigned>(sampleRate),
+                        static_cast<unsigned long>(juce::roundToInt(meterRate)),
                         mode);
 
     if (state == nullptr)
@@ -57,6 +87,7 @@ void LoudnessMeter::prepare(double sampleRate, int numChannels, int /*maxSamples
     }
 
     reset();
+    windowFilledFromSilence = true; // A new state starts with an all-zero window
 }
 
 //==============================================================================
@@ -65,9 +96,52 @@ void LoudnessMeter::reset()
     // Reset cached measurement values to their initial states
     lastShortTermLUFS = -144.0f;  // Minimum valid loudness
     lastMomentaryLUFS = -144.0f;
-    lastLRA = 0.0f;
-    // Note: A 'harder' reset for libebur128's internal LRA history would be to call prepare() again.
-    // For now, this resets our cached values. libebur128's LRA is continuous.
+    decimator.reset();
+
+    // Start a new LRA history. The short-term window still holds up to 3 s of
+    // earlier audio, so wait for it to refill before taking values again.
+    lraHistogram.reset();
+    lraEstimator.reset();
+    microDynamics.reset();
+    if (multibandActive)
+        multiband.reset();
+    samplesUntilShortTermHop = gatingHopSamples;
+    shortTermHopsSinceReset = 0;
+    hopsUntilExposureSecond = EXPOSURE_SECOND_HOPS;
+    windowFilledFromSilence = false;
+    estimatedHopsRemaining = 0;
+
+    std::fill(timelineValues.begin(), timelineValues.end(), std::numeric_limits<float>::quiet_NaN());
+    timelineFrame = timelineAligned ? awaitingTimeline : noTimeline;
+}
+
+void LoudnessMeter::setTimelinePosition(juce::int64 timelineSample)
+{
+    if (! timelineAligned || state == nullptr)
+        return;
+
+    const juce::int64 frame = (timelineSample < 0) ? noTimeline : timelineSample / decimator.getFactor();
+
+    // Where the meter thinks it is, including silence it has skipped
+    const juce::int64 currentFrame = (timelineFrame >= 0) ? timelineFrame + skippedSilentSamples : timelineFrame;
+    if (frame == currentFrame || (frame >= 0 && currentFrame >= 0 && std::abs(frame - currentFrame) <= 1))
+        return; // Contiguous (within decimation rounding)
+
+    // Settle skipped silence at the old position; its remainder belongs to nothing now
+    if (skippedSilentSamples > 0)
+    {
+        advanceTimelineThroughSilence(skippedSilentSamples - skippedSilentSamples % gatingHopSamples);
+        skippedSilentSamples = 0;
+    }
+
+    // The short-term window now holds audio from elsewhere on the timeline
+    timelineFrame = frame;
+    shortTermHopsSinceReset = 0;
+    windowFilledFromSilence = false;
+
+    // Put hop boundaries on the timeline grid so every pass lands on the same slots
+    if (frame >= 0)
+        samplesUntilShortTermHop = gatingHopSamples - static_cast<int>(frame % gatingHopSamples);
 }
 
 //==============================================================================
@@ -86,39 +160,285 @@ void LoudnessMeter::processBlock(const juce::AudioBuffer<float>& buffer)
         return; // Mismatch, can't process
     }
         
-    const int numFrames = buffer.getNumSamples(); // In libebur128, 'frames means samples per channel.
+    // The decimator's buffers are sized for the prepared block size
+    if (buffer.getNumSamples() > maxInputBlockSize)
+    {
+        for (int start = 0; start < buffer.getNumSamples(); start += maxInputBlockSize)
+        {
+            const int length = juce::jmin(maxInputBlockSize, buffer.getNumSamples() - start);
+            juce::AudioBuffer<float> piece (const_cast<float* const*>(buffer.getArrayOfReadPointers()),
+                                            buffer.getNumChannels(), start, length);
+            processBlock(piece);
+        }
+        return;
+    }
+
     const int numChans = currentNumChannels;
+
+    // Silence fast path: once the window is flushed, just advance the clock
+    // (counted in meter-rate frames; the decimator only advances its phase)
+    const bool silent = isSilent(buffer);
+    if (silent && consecutiveSilentSamples >= silenceFlushSamples)
+    {
+        skippedSilentSamples += decimator.skip(buffer.getNumSamples());
+        return;
+    }
+
+    const auto& meterBlock = decimator.process(buffer);
+    const int numFrames = meterBlock.getNumSamples(); // In libebur128, 'frames means samples per channel.
+
+    if (silent)
+    {
+        consecutiveSilentSamples += numFrames; // Still flushing the window, filter normally
+    }
+    else
+    {
+        resumeAfterSilence();
+        consecutiveSilentSamples = 0;
+    }
     
-    // Prepare interleaved buffer for libebur128
-    std::vector<float> interleavedData;
-    interleavedData.resize(static_cast<size_t>(numFrames * numChans));
+    // Prepare interleaved buffer for libebur128 (only grows for unusually large blocks)
+    const auto requiredSize = static_cast<size_t>(numFrames * numChans);
+    if (tempInterleaveBuffer.size() < requiredSize)
+        tempInterleaveBuffer.resize(requiredSize);
+    float* interleavedData = tempInterleaveBuffer.data();
     
     // Convert planar audio data to interleaved format
     for (int i = 0; i < numFrames; ++i)
     {
         for (int ch = 0; ch < numChans; ++ch)
         {
-            const float* channelReadPtr = buffer.getReadPointer(ch);
+            const float* channelReadPtr = meterBlock.getReadPointer(ch);
             float sampleValue = channelReadPtr[i];
             interleavedData[static_cast<size_t>(i * numChans + ch)] = sampleValue;
         }
     }
     
     // Process the audio block with libebur128
-    int err = ebur128_add_frames_float(state, interleavedData.data(), static_cast<size_t>(numFrames));
-    
-    if (err != 0)
-    {
-        DBG("libebur128_add_frames_float error code: " << err);
-        // In a release build, you might want to log this or handle it more gracefully than just asserting. For debugging, an assert is fine.
-        jassertfalse;  // Error in libeur128 processing
-    }
+    addFrames(interleavedData, numFrames);
     
     // Note: The getter methods will be called from PluginProcessor to retrieve values.
     // We don't necessarily need to update lastShortTermLUFS etc. here, as the getters
     // will fetch the latest from libebur128.
 }
 
+//==============================================================================
+void LoudnessMeter::addFrames(const float* interleavedData, int numFrames)
+{
+    while (numFrames > 0)
+    {
+        // Split at the hop boundary so each short-term value is taken on the exact frame
+        const int framesThisPass = juce::jmin(numFrames, juce::jmax(1, samplesUntilShortTermHop));
+
+        int err = ebur128_add_frames_float(state, interleavedData, static_cast<size_t>(framesThisPass));
+        if (err != 0)
+        {
+            DBG("libebur128_add_frames_float error code: " << err);
+            jassertfalse;  // Error in libeur128 processing
+        }
+
+        microDynamics.process(interleavedData, framesThisPass, currentNumChannels);
+        if (multibandActive)
+            multiband.process(interleavedData, framesThisPass);
+
+        interleavedData += framesThisPass * currentNumChannels;
+        numFrames -= framesThisPass;
+        samplesUntilShortTermHop -= framesThisPass;
+        if (timelineFrame >= 0)
+            timelineFrame += framesThisPass;
+
+        if (samplesUntilShortTermHop <= 0)
+        {
+            samplesUntilShortTermHop = gatingHopSamples;
+            ++shortTermHopsSinceReset;
+
+            const bool windowIsFull = shortTermHopsSinceReset >= SHORT_TERM_WINDOW_HOPS;
+            const bool windowIsStale = estimatedHopsRemaining > 0; // Refilling after bridgeUnfiltered()
+            if (windowIsStale)
+                --estimatedHopsRemaining;
+
+            if (multibandActive)
+                multiband.finishHop(windowIsFull && ! windowIsStale);
+
+            double lufs_s;
+            if (windowIsStale)
+            {
+                // Part of the window is from before the bridged stretch: keep to the estimate
+                if (windowIsFull)
+                    takeEstimatedValue(bridgeEstimateLUFS);
+                microDynamics.finishHop(std::numeric_limits<double>::quiet_NaN());
+            }
+            else if (windowIsFull)
+            {
+                if (ebur128_loudness_shortterm(state, &lufs_s) == 0)
+                {
+                    takeShortTermValue(lufs_s);
+                    if (timelineFrame != awaitingTimeline)
+                        lraEstimator.add(lufs_s);
+                    microDynamics.finishHop(lufs_s);
+                }
+                else
+                {
+                    microDynamics.finishHop(std::numeric_limits<double>::quiet_NaN());
+                }
+            }
+            else if (windowFilledFromSilence && shortTermHopsSinceReset >= PROVISIONAL_MIN_HOPS
+                     && ebur128_loudness_shortterm(state, &lufs_s) == 0)
+            {
+                // The rest of the window is zeros: the same energy over the part holding audio
+                lraEstimator.add(lufs_s + 10.0 * std::log10(static_cast<double>(SHORT_TERM_WINDOW_HOPS) / shortTermHopsSinceReset));
+            }
+
+            // No PSR until the window is full
+            if (! windowIsFull && ! windowIsStale)
+                microDynamics.finishHop(std::numeric_limits<double>::quiet_NaN());
+
+            if (--hopsUntilExposureSecond <= 0)
+            {
+                hopsUntilExposureSecond = EXPOSURE_SECOND_HOPS;
+                double lufs_1s;
+                if (ebur128_loudness_window(state, 1000, &lufs_1s) == 0 && std::isfinite(lufs_1s))
+                    exposureEnergySeconds += std::pow(10.0, lufs_1s / 10.0);
+                ++exposureSeconds;
+            }
+        }
+    }
+}
+
+void LoudnessMeter::bridgeUnfiltered(int numSamples, double estimatedLUFS)
+{
+    if (state == nullptr || numSamples <= 0)
+        return;
+
+    // Settle skipped silence first, so the hop phase is right
+    resumeAfterSilence();
+    consecutiveSilentSamples = 0;
+    windowFilledFromSilence = false;
+
+    bridgeEstimateLUFS = estimatedLUFS;
+    estimatedHopsRemaining = SHORT_TERM_WINDOW_HOPS;
+
+    // Same hop bookkeeping as addFrames(), with the estimate in place of the window
+    for (int numFrames = decimator.skip(numSamples); numFrames > 0;)
+    {
+        const int framesThisPass = juce::jmin(numFrames, juce::jmax(1, samplesUntilShortTermHop));
+        numFrames -= framesThisPass;
+        samplesUntilShortTermHop -= framesThisPass;
+        if (timelineFrame >= 0)
+            timelineFrame += framesThisPass;
+
+        if (samplesUntilShortTermHop > 0)
+            continue;
+
+        samplesUntilShortTermHop = gatingHopSamples;
+        ++shortTermHopsSinceReset;
+
+        if (shortTermHopsSinceReset >= SHORT_TERM_WINDOW_HOPS)
+            takeEstimatedValue(estimatedLUFS);
+        microDynamics.finishHop(std::numeric_limits<double>::quiet_NaN());
+        if (multibandActive)
+            multiband.finishHop(false);
+
+        if (--hopsUntilExposureSecond <= 0)
+        {
+            hopsUntilExposureSecond = EXPOSURE_SECOND_HOPS;
+            if (std::isfinite(estimatedLUFS))
+                exposureEnergySeconds += std::pow(10.0, estimatedLUFS / 10.0);
+            ++exposureSeconds;
+        }
+    }
+}
+
+void LoudnessMeter::takeEstimatedValue(double lufs)
+{
+    // A value measured on an earlier pass over the same stretch beats an estimate
+    if (timelineFrame >= 0)
+    {
+        const auto hop = timelineFrame / gatingHopSamples;
+        if (juce::isPositiveAndBelow(hop, static_cast<juce::int64>(timelineValues.size()))
+            && ! std::isnan(timelineValues[static_cast<size_t>(hop)]))
+            return;
+    }
+
+    takeShortTermValue(lufs);
+}
+
+void LoudnessMeter::takeShortTermValue(double lufs)
+{
+    if (timelineFrame == noTimeline)
+        lraHistogram.addShortTermLoudness(lufs);
+    else if (timelineFrame >= 0)
+        storeTimelineValue(timelineFrame / gatingHopSamples, lufs); // timelineFrame sits on a hop boundary here
+}
+
+void LoudnessMeter::storeTimelineValue(juce::int64 hop, double lufs)
+{
+    if (! juce::isPositiveAndBelow(hop, static_cast<juce::int64>(timelineValues.size())))
+        return;
+
+    // Values go through float so the exact same value can be removed later
+    auto& slot = timelineValues[static_cast<size_t>(hop)];
+    if (! std::isnan(slot))
+        lraHistogram.removeShortTermLoudness(slot);
+
+    const bool isGated = ! std::isfinite(lufs) || lufs < LoudnessRangeHistogram::minLoudness;
+    slot = isGated ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(lufs);
+
+    if (! std::isnan(slot))
+        lraHistogram.addShortTermLoudness(slot);
+}
+
+void LoudnessMeter::advanceTimelineThroughSilence(juce::int64 numFrames)
+{
+    if (timelineFrame < 0 || numFrames <= 0)
+        return;
+
+    // The hop phase is unchanged by whole hops of silence: one boundary per hop,
+    // the first samplesUntilShortTermHop frames in. Silence is below the gate.
+    const juce::int64 firstBoundary = timelineFrame + samplesUntilShortTermHop;
+    for (juce::int64 boundary = firstBoundary; boundary <= timelineFrame + numFrames; boundary += gatingHopSamples)
+        storeTimelineValue(boundary / gatingHopSamples, std::numeric_limits<double>::quiet_NaN());
+
+    timelineFrame += numFrames;
+}
+
+//==============================================================================
+bool LoudnessMeter::isSilent(const juce::AudioBuffer<float>& buffer) const
+{
+    const float threshold = juce::Decibels::decibelsToGain(SILENCE_THRESHOLD_DB);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) >= threshold)
+            return false;
+    }
+    return true;
+}
+
+void LoudnessMeter::resumeAfterSilence()
+{
+    if (skippedSilentSamples == 0)
+        return;
+
+    // Only the position within the current 100 ms hop matters; whole hops of
+    // silence would have produced gated-out blocks and nothing else.
+    // On the timeline those hops now hold silence, so their old values go.
+    auto zerosToFeed = static_cast<int>(skippedSilentSamples % gatingHopSamples);
+    advanceTimelineThroughSilence(skippedSilentSamples - zerosToFeed);
+    skippedSilentSamples = 0;
+
+    while (zerosToFeed > 0)
+    {
+        const int framesThisPass = juce::jmin(zerosToFeed, static_cast<int>(tempInterleaveBuffer.size()) / currentNumChannels);
+        if (framesThisPass <= 0)
+            break;
+
+        std::fill(tempInterleaveBuffer.begin(), tempInterleaveBuffer.begin() + framesThisPass * currentNumChannels, 0.0f);
+        addFrames(tempInterleaveBuffer.data(), framesThisPass);
+        zerosToFeed -= framesThisPass;
+    }
+}
+
 //==============================================================================
 float LoudnessMeter::getShortTermLoudness() const
 {
@@ -152,16 +472,111 @@ float LoudnessMeter::getMomentaryLoudness() const
 }
 
 //==============================================================================
-float LoudnessMeter::getLoudnessRange() const
+float LoudnessMeter::getLoudnessRange()
 {
     if (state == nullptr) return 0.0f;  // LRA is typically positive or zero
-    
-    double lra_val;
-    if (ebur128_loudness_range(state, &lra_val) == 0)
+
+    return lraHistogram.computeLoudnessRange();
+}
+
+MicroDynamicsTracker::Summary LoudnessMeter::getMicroDynamics() const
+{
+    double integrated = -std::numeric_limits<double>::infinity();
+    if (state != nullptr && ebur128_loudness_global(state, &integrated) != 0)
+        integrated = -std::numeric_limits<double>::infinity();
+
+    return microDynamics.getSummary(integrated);
+}
+
+void LoudnessMeter::writeSnapshot(juce::OutputStream& output) const
+{
+    output.writeBool(timelineAligned);
+    output.writeBool(multibandActive);
+
+    if (timelineAligned)
+    {
+        // Up to the last hop that holds a value; NaN marks the empty ones
+        auto numValues = timelineValues.size();
+        while (numValues > 0 && std::isnan(timelineValues[numValues - 1]))
+            --numValues;
+
+        output.writeInt(static_cast<int>(numValues));
+        for (size_t hop = 0; hop < numValues; ++hop)
+            output.writeFloat(timelineValues[hop]);
+    }
+    else
+    {
+        lraHistogram.writeToStream(output);
+    }
+
+    if (multibandActive)
+        multiband.writeHistograms(output);
+}
+
+bool LoudnessMeter::restoreSnapshot(juce::InputStream& input)
+{
+    if (state == nullptr)
+        return false;
+
+    reset();
+
+    const bool wasTimelineAligned = input.readBool();
+    const bool hadBands = input.readBool();
+    if (wasTimelineAligned != timelineAligned)
+        return false;
+
+    bool restored = true;
+    if (timelineAligned)
+    {
+        const int numValues = input.readInt();
+        restored = juce::isPositiveAndNotGreaterThan(numValues, static_cast<int>(timelineValues.size()));
+        for (int hop = 0; restored && hop < numValues; ++hop)
+            storeTimelineValue(hop, input.readFloat());
+    }
+    else
     {
-        lastLRA = static_cast<float>(lra_val);
-        return static_cast<float>(lra_val);
+        restored = lraHistogram.readFromStream(input);
     }
-    // DBG ("Error getting loudness range from libebur128");
-    return lastLRA; // Return cached value on error
+
+    // Bands saved with band analysis off now are left behind; bands switched on since start empty
+    if (restored && hadBands && multibandActive)
+        restored = multiband.readHistograms(input);
+
+    if (! restored)
+        reset();
+
+    return restored;
+}
+
+void LoudnessMeter::takeExposure(double& energySeconds, int& numSeconds)
+{
+    energySeconds = exposureEnergySeconds;
+    numSeconds = exposureSeconds;
+    exposureEnergySeconds = 0.0;
+    exposureSeconds = 0;
+}
+
+MultibandLoudness::Summary LoudnessMeter::getBandSummary()
+{
+    MultibandLoudness::Summary summary;
+    if (! multibandActive || state == nullptr)
+        return summary;
+
+    summary.isAvailable = true;
+    for (int band = 0; band < MultibandLoudness::numBands; ++band)
+    {
+        summary.lra[static_cast<size_t>(band)] = multiband.computeLoudnessRange(band);
+        summary.shortTermLUFS[static_cast<size_t>(band)] = multiband.getShortTermLoudness(band);
+    }
+    return summary;
+}
+
+void LoudnessMeter::beginLoudnessRange()
+{
+    lraHistogram.beginEvaluation();
+}
+
+bool LoudnessMeter::continueLoudnessRange(int maxBins)
+{
+    return lraHistogram.continueEvaluation(maxBins);
 }
@@ -2,6 +2,11 @@
 
 #include <juce_audio_basics/juce_audio_basics.h> // For juce::AudioBuffer
 #include "ebur128.h" // <<< Crucial: Include the C library's header
+#include "LoudnessRangeHistogram.h"
+#include "LoudnessRangeEstimator.h"
+#include "MultibandLoudness.h"
+#include "MicroDynamicsTracker.h"
+#include "AnalysisDecimator.h"
 
 //==============================================================================
 /**
@@ -13,6 +18,36 @@
  * - Short-term loudness
  * - Momentary loudness
  * - Loudness Range (LRA)
+ *
+ * Silent input takes a fast path: once the 3-second short-term window holds
+ * nothing but silence, further silent blocks are not filtered at all. Such
+ * blocks sit below the -70 LUFS absolute gate and never count towards LRA, so
+ * skipping them is exact; only the 100 ms gating phase has to be kept, which
+ * is done by feeding the remainder as zeros when audio resumes. Audio the
+ * processor chooses not to analyse is bridged on an estimate instead
+ * (bridgeUnfiltered()).
+ *
+ * LRA is not left to libebur128: a short-term value is taken every 100 ms and
+ * binned in a LoudnessRangeHistogram. Memory stays constant over long sessions
+ * and the evaluation can be spread over several calls (beginLoudnessRange()
+ * and continueLoudnessRange()) instead of landing on one.
+ *
+ * While the first window fills, a LoudnessRangeEstimator gives a provisional
+ * LRA with a confidence interval. Until the window is full, short-term values
+ * from a fresh meter are scaled to the part of the window that holds audio.
+ *
+ * The same pass feeds a MicroDynamicsTracker (PSR, PLR and crest factor), and
+ * once a second the energy of the last second goes to the listening dose.
+ *
+ * An optional MultibandLoudness stage measures short-term loudness and LRA in
+ * four bands on the same hops (not in timeline-aligned mode).
+ *
+ * Optionally the values are keyed to the host timeline rather than appended,
+ * so re-played regions replace their earlier values (setTimelineAligned()).
+ *
+ * At 88.2 kHz and above the audio is decimated to 44.1/48 kHz before
+ * K-weighting (see AnalysisDecimator), as loudness only depends on the
+ * audible band. Peak metering is not done here and stays at the full rate.
  */
 class LoudnessMeter
 {
@@ -30,6 +65,43 @@ public:
      */
     void prepare(double sampleRate, int numChannels, int maxSamplesPerBlock);
 
+    /**
+     * Enables the high-rate decimation path. Takes effect at the next prepare().
+     */
+    void setDecimationEnabled(bool shouldDecimate) { decimationEnabled = shouldDecimate; }
+
+    /** Rate libebur128 runs at after decimation. */
+    double getAnalysisSampleRate() const { return decimator.getOutputSampleRate(); }
+
+    /**
+     * Keys short-term values to host timeline position instead of appending
+     * them (see setTimelinePosition()). Takes effect at the next prepare().
+     */
+    void setTimelineAligned(bool shouldAlign) { timelineAligned = shouldAlign; }
+
+    /**
+     * Enables per-band analysis (see MultibandLoudness). Takes effect at the
+     * next prepare(), and is ignored in timeline-aligned mode.
+     */
+    void setMultibandEnabled(bool shouldAnalyseBands) { multibandEnabled = shouldAnalyseBands; }
+
+    /** True if the band analysis is running since the last prepare(). */
+    bool isMultibandActive() const { return multibandActive; }
+
+    /**
+     * Tells the meter where on the host timeline the next sample it processes
+     * lies, in input samples, or -1 if the host has no timeline. Only needed at
+     * discontinuities (start of playback, locate, loop wrap): the position
+     * advances with the audio in between.
+     *
+     * In timeline-aligned mode each 100 ms of timeline holds at most one
+     * short-term value. Playing a region again replaces its values in the LRA
+     * histogram, so loops don't count twice and an edited region is re-measured
+     * just by playing it. After a jump the 3 s window has to refill before new
+     * values are taken. Until the first call after a reset nothing is taken.
+     */
+    void setTimelinePosition(juce::int64 timelineSample);
+
     /**
      * Resets all internal measurements and state.
      * Call this when starting a new measurement session.
@@ -44,6 +116,24 @@ public:
      */
     void processBlock(const juce::AudioBuffer<float>& buffer);
 
+    /**
+     * True if the last processed block was skipped by the silence fast path.
+     */
+    bool isSkippingSilence() const { return skippedSilentSamples > 0; }
+
+    /**
+     * Moves the measurement through audio that is not filtered at all (the
+     * processor's Economy tier). Each 100 ms hop it covers takes estimatedLUFS
+     * as its short-term value and each second goes to the listening dose at
+     * that level; in timeline-aligned mode only empty slots are filled, so a
+     * measured earlier pass is kept. PSR, crest factor and the bands pause.
+     *
+     * When processBlock() is called again, the short-term window still holds
+     * audio from before the bridged stretch, so the estimate stands in for
+     * another 3 s while the window refills with real audio.
+     */
+    void bridgeUnfiltered(int numSamples, double estimatedLUFS);
+
     /**
      * Retrieves the short-term loudness measurement.
      * This is the loudness measured over a 3-second window.
@@ -63,10 +153,65 @@ public:
     /**
      * Retrieves the Loudness Range (LRA) measurement.
      * LRA represents the variation in loudness over time.
+     * Evaluates the whole histogram in one go; time-critical callers should
+     * use beginLoudnessRange() and continueLoudnessRange() instead.
      * 
      * @return Loudness Range in LU, or 0.0 if insufficient data
      */
-    float getLoudnessRange() const;
+    float getLoudnessRange();
+
+    /**
+     * Starts a resumable LRA evaluation of the audio processed so far.
+     * Audio processed while it runs is included in the next evaluation.
+     */
+    void beginLoudnessRange();
+
+    /**
+     * Advances the running evaluation by at most maxBins histogram bins.
+     * 
+     * @return true once the result is available from getLastLoudnessRange()
+     */
+    bool continueLoudnessRange(int maxBins);
+
+    /** True while an evaluation started by beginLoudnessRange() is unfinished. */
+    bool isEvaluatingLoudnessRange() const { return lraHistogram.isEvaluating(); }
+
+    /** LRA from the last completed evaluation, in LU. */
+    float getLastLoudnessRange() const { return lraHistogram.getLoudnessRange(); }
+
+    /** Running LRA estimate with its confidence interval, available after a couple of seconds. */
+    LoudnessRangeEstimator::Estimate getProvisionalLoudnessRange() const { return lraEstimator.getEstimate(); }
+
+    /**
+     * Per-band short-term loudness and LRA. Evaluates every band's histogram
+     * in full, a fixed 1000 bins each; not available unless isMultibandActive().
+     */
+    MultibandLoudness::Summary getBandSummary();
+
+    /** PSR, PLR and crest factor; PLR uses libebur128's integrated loudness (histogram mode). */
+    MicroDynamicsTracker::Summary getMicroDynamics() const;
+
+    /**
+     * Hands over the programme measured since the last call for the listening
+     * dose: whole seconds, and their summed 1 s energies relative to 0 LUFS.
+     * Neither prepare() nor reset() clears it, so a restart loses nothing.
+     */
+    void takeExposure(double& energySeconds, int& numSeconds);
+
+    /**
+     * Writes the measurement history so a saved session carries on where it
+     * left off: the LRA histogram (or the timeline values in timeline-aligned
+     * mode) and the band histograms. libebur128's own state is not included,
+     * so the short-term window refills and PLR starts again after a restore.
+     */
+    void writeSnapshot(juce::OutputStream& output) const;
+
+    /**
+     * Restores a history written by writeSnapshot() into a freshly prepared
+     * meter. Returns false, leaving the meter reset, if the snapshot was taken
+     * in the other timeline mode or is damaged.
+     */
+    bool restoreSnapshot(juce::InputStream& input);
 
     // Optional: Add getters for Integrated Loudness if needed later.
     // float getIntegratedLoudness() const;
@@ -78,14 +223,85 @@ private:
     ebur128_state* state = nullptr; // Pointer to the libebur128 state object
     int currentNumChannels = 0;
     double currentSampleRate = 0.0;
+    int maxInputBlockSize = 0;                  // Larger blocks are split before decimation
+
+    // High-rate decimation in front of libebur128
+    AnalysisDecimator decimator;
+    bool decimationEnabled = true;
 
     // Cached measurement results
     mutable float lastShortTermLUFS = -144.0f;  // Minimum valid loudness
     mutable float lastMomentaryLUFS = -144.0f;
-    mutable float lastLRA = 0.0f;
+
+    // Loudness Range from short-term values taken every gating hop
+    LoudnessRangeHistogram lraHistogram;
+    int samplesUntilShortTermHop = 0;         // Frames until the next short-term value is taken
+    int shortTermHopsSinceReset = 0;          // Hops seen, to skip values from a partly filled window
+    static constexpr int SHORT_TERM_WINDOW_HOPS = 30; // 3 s short-term window in 100 ms hops
+
+    // Provisional LRA while the measurement is young
+    LoudnessRangeEstimator lraEstimator;
+    bool windowFilledFromSilence = false;     // Window held only zeros before this run (fresh libebur128 state)
+    static constexpr int PROVISIONAL_MIN_HOPS = 4; // First scaled value after one momentary window
+
+    // Peak-to-loudness ratios and crest factor on the same hops
+    MicroDynamicsTracker microDynamics;
+
+    // Listening exposure: one 1 s window every ten hops
+    static constexpr int EXPOSURE_SECOND_HOPS = 10;
+    int hopsUntilExposureSecond = EXPOSURE_SECOND_HOPS;
+    double exposureEnergySeconds = 0.0;       // Since the last takeExposure()
+    int exposureSeconds = 0;
+
+    // Per-band analysis on the same hops
+    MultibandLoudness multiband;
+    bool multibandEnabled = false;            // Requested, applied at prepare()
+    bool multibandActive = false;             // Running since the last prepare()
     
+    // Timeline-aligned mode: one short-term value per hop of host timeline
+    bool timelineAligned = false;
+    std::vector<float> timelineValues;        // Per timeline hop, NaN where nothing is stored
+    juce::int64 timelineFrame = -1;           // Meter-rate timeline position of the next frame
+    static constexpr juce::int64 noTimeline = -1;       // Host has no timeline: values are appended
+    static constexpr juce::int64 awaitingTimeline = -2; // Position unknown since reset: values are dropped
+    static constexpr double MAX_TIMELINE_SECONDS = 6.0 * 3600.0; // Later positions are not measured
+
     // Buffer for interleaved audio data
     std::vector<float> tempInterleaveBuffer; // <<< Member Variable for interleavedData
 
+    // Silence fast path state
+    int gatingHopSamples = 0;                 // 100 ms short-term hop, the phase we must preserve
+    juce::int64 silenceFlushSamples = 0;      // Silence to filter before skipping starts
+    juce::int64 consecutiveSilentSamples = 0; // Silence filtered so far in the current run
+    juce::int64 skippedSilentSamples = 0;     // Silence skipped (not filtered) in the current run
+
+    // Economy bridging: the window refills after a stretch that was not filtered
+    double bridgeEstimateLUFS = 0.0;          // Estimate from the last bridgeUnfiltered()
+    int estimatedHopsRemaining = 0;           // Hops that still take the estimate, not the stale window
+
+    static constexpr float SILENCE_THRESHOLD_DB = -80.0f;     // Peak below this is under the -70 LUFS gate
+    static constexpr double SILENCE_FLUSH_SECONDS = 3.5;      // Short-term window plus filter tail
+
+    /** True if every channel of the block peaks below SILENCE_THRESHOLD_DB. */
+    bool isSilent(const juce::AudioBuffer<float>& buffer) const;
+
+    /** Feeds the skipped silence modulo one hop as zeros, keeping the gating phase. */
+    void resumeAfterSilence();
+
+    /** Adds interleaved frames to libebur128, taking a short-term value at every hop boundary. */
+    void addFrames(const float* interleavedData, int numFrames);
+
+    /** Puts a short-term value in the histogram, or in its timeline slot. */
+    void takeShortTermValue(double lufs);
+
+    /** Replaces the value of one timeline hop (NaN or a gated value clears it). */
+    void storeTimelineValue(juce::int64 hop, double lufs);
+
+    /** Like takeShortTermValue(), but never replaces a measured timeline value. */
+    void takeEstimatedValue(double lufs);
+
+    /** Moves the timeline through skipped silence, clearing the hops it covers. */
+    void advanceTimelineThroughSilence(juce::int64 numFrames);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessMeter)
 };
@@ -0,0 +1,160 @@
+#include "LoudnessRangeEstimator.h"
+#include <cmath>     // For std::pow, std::log10, std::sqrt, std::isfinite
+#include <algorithm> // For std::sort, std::copy
+
+//==============================================================================
+void LoudnessRangeEstimator::P2Quantile::reset (double p)
+{
+    probability = p;
+    count = 0;
+
+    const double initialDesired[5] { 0.0, 2.0 * p, 4.0 * p, 2.0 + 2.0 * p, 4.0 };
+    const double initialIncrements[5] { 0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0 };
+    for (int i = 0; i < 5; ++i)
+    {
+        heights[i] = 0.0;
+        positions[i] = i;
+        desired[i] = initialDesired[i];
+        increments[i] = initialIncrements[i];
+    }
+}
+
+void LoudnessRangeEstimator::P2Quantile::add (double x)
+{
+    // The first five values become the markers
+    if (count < 5)
+    {
+        heights[count++] = x;
+        if (count == 5)
+            std::sort(heights, heights + 5);
+        return;
+    }
+
+    // Cell the value falls into, stretching the extremes if needed
+    int cell;
+    if (x < heights[0])
+    {
+        heights[0] = x;
+        cell = 0;
+    }
+    else if (x >= heights[4])
+    {
+        heights[4] = x;
+        cell = 3;
+    }
+    else
+    {
+        cell = 0;
+        while (x >= heights[cell + 1])
+            ++cell;
+    }
+
+    for (int i = cell + 1; i < 5; ++i)
+        positions[i] += 1.0;
+    for (int i = 0; i < 5; ++i)
+        desired[i] += increments[i];
+    ++count;
+
+    // Move the middle markers towards their desired positions by one step at most
+    for (int i = 1; i <= 3; ++i)
+    {
+        const double offset = desired[i] - positions[i];
+        if ((offset >= 1.0 && positions[i + 1] - positions[i] > 1.0)
+            || (offset <= -1.0 && positions[i - 1] - positions[i] < -1.0))
+        {
+            const int step = (offset > 0.0) ? 1 : -1;
+            const double candidate = parabolic(i, step);
+            heights[i] = (heights[i - 1] < candidate && candidate < heights[i + 1]) ? candidate : linear(i, step);
+            positions[i] += step;
+        }
+    }
+}
+
+double LoudnessRangeEstimator::P2Quantile::parabolic (int i, double d) const
+{
+    return heights[i] + d / (positions[i + 1] - positions[i - 1])
+               * ((positions[i] - positions[i - 1] + d) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i])
+                  + (positions[i + 1] - positions[i] - d) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+}
+
+double LoudnessRangeEstimator::P2Quantile::linear (int i, int d) const
+{
+    return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+}
+
+double LoudnessRangeEstimator::P2Quantile::get() const
+{
+    if (count >= 5)
+        return heights[2];
+
+    if (count == 0)
+        return 0.0;
+
+    // Too few values for markers: interpolate between the sorted values
+    double sorted[5];
+    std::copy(heights, heights + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    const double rank = probability * (count - 1);
+    const int below = static_cast<int>(rank);
+    const int above = juce::jmin(below + 1, count - 1);
+    return sorted[below] + (rank - below) * (sorted[above] - sorted[below]);
+}
+
+//==============================================================================
+LoudnessRangeEstimator::LoudnessRangeEstimator()
+{
+    reset();
+}
+
+void LoudnessRangeEstimator::reset()
+{
+    low.reset(lowPercentile);
+    high.reset(highPercentile);
+    gatedEnergySum = 0.0;
+    numAbsoluteGated = 0;
+    mean = 0.0;
+    sumOfSquares = 0.0;
+    numCounted = 0;
+}
+
+void LoudnessRangeEstimator::add (double lufs)
+{
+    if (! std::isfinite(lufs) || lufs < absoluteGate)
+        return;
+
+    gatedEnergySum += std::pow(10.0, lufs / 10.0);
+    ++numAbsoluteGated;
+
+    if (lufs < 10.0 * std::log10(gatedEnergySum / numAbsoluteGated) + relativeGate)
+        return;
+
+    low.add(lufs);
+    high.add(lufs);
+
+    ++numCounted;
+    const double delta = lufs - mean;
+    mean += delta / numCounted;
+    sumOfSquares += delta * (lufs - mean);
+}
+
+LoudnessRangeEstimator::Estimate LoudnessRangeEstimator::getEstimate() const
+{
+    Estimate estimate;
+    estimate.numValues = numCounted;
+    if (numCounted == 0)
+        return estimate;
+
+    estimate.lra = static_cast<float>(juce::jmax(0.0, high.get() - low.get()));
+
+    // Standard error of a normal p-quantile is sqrt(p(1-p)) / density(z_p) * sigma / sqrt(n):
+    // 1.709 for the 10th and 2.114 for the 95th percentile. Leaving out their
+    // covariance errs on the wide side, as the two estimates move together.
+    constexpr double lowErrorFactor = 1.709, highErrorFactor = 2.114;
+    const double sigma = (numCounted > 1) ? std::sqrt(sumOfSquares / (numCounted - 1)) : 0.0;
+    const double independentValues = juce::jmax(1.0, static_cast<double>(numCounted) / valuesPerIndependentValue);
+    const double standardError = std::sqrt(lowErrorFactor * lowErrorFactor + highErrorFactor * highErrorFactor)
+                                 * sigma / std::sqrt(independentValues);
+    estimate.halfWidth = static_cast<float>(confidenceZ * standardError);
+    return estimate;
+}
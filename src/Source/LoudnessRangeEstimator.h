@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+ * Running estimate of the Loudness Range with a confidence interval, for the
+ * first seconds of a measurement before the exact histogram value is shown.
+ *
+ * The 10th and 95th percentiles are tracked with P-square estimators (Jain &
+ * Chlamtac), which keep five markers each instead of the values themselves,
+ * so every update is O(1) in time and memory. Values pass the absolute gate
+ * and the relative gate as it stands when they arrive; the gate can't be
+ * applied again to values already counted, which only matters while the
+ * programme's level is still settling. The estimate converges to the
+ * percentiles of the data as values accumulate.
+ *
+ * The interval is the asymptotic standard error of both percentiles of a
+ * normal distribution with the values' spread, counting one independent
+ * value per momentary (400 ms) window because neighbouring short-term values
+ * overlap.
+ */
+class LoudnessRangeEstimator
+{
+public:
+    static constexpr double absoluteGate = -70.0;         // LUFS, as in EBU Tech 3342
+    static constexpr double relativeGate = -20.0;         // LU below the power mean of the gated values
+    static constexpr double lowPercentile = 0.10;
+    static constexpr double highPercentile = 0.95;
+    static constexpr int valuesPerIndependentValue = 4;   // Short-term hops per momentary window
+    static constexpr double confidenceZ = 1.96;           // 95 % interval
+    static constexpr int minValuesForEstimate = 16;       // 1.6 s of hops before an estimate is offered
+
+    struct Estimate
+    {
+        float lra = 0.0f;                                   // LU
+        float halfWidth = 0.0f;                             // LU either side of lra
+        int numValues = 0;                                  // Values that passed both gates
+
+        bool isUsable() const noexcept { return numValues >= minValuesForEstimate; }
+    };
+
+    LoudnessRangeEstimator();
+
+    /** Forgets every value. */
+    void reset();
+
+    /** Adds one short-term loudness value in LUFS; gated values are ignored. */
+    void add (double lufs);
+
+    /** Current estimate (O(1)). */
+    Estimate getEstimate() const;
+
+private:
+    /** P-square estimator for one quantile: five markers and their positions. */
+    struct P2Quantile
+    {
+        double probability = 0.5;
+        double heights[5] {};                               // Marker heights (the first five values until full)
+        double positions[5] {};                             // Actual marker positions
+        double desired[5] {};                               // Desired marker positions
+        double increments[5] {};                            // Growth of the desired positions per value
+        int count = 0;
+
+        void reset (double p);
+        void add (double x);
+        double get() const;
+
+    private:
+        double parabolic (int i, double d) const;
+        double linear (int i, int d) const;
+    };
+
+    P2Quantile low, high;
+    double gatedEnergySum = 0.0;                            // Sum of 10^(L/10) over absolute-gated values
+    int numAbsoluteGated = 0;
+    double mean = 0.0, sumOfSquares = 0.0;                  // Welford's running mean and M2 of counted values
+    int numCounted = 0;
+};
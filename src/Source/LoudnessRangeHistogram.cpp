@@ -0,0 +1,266 @@
+#include "LoudnessRangeHistogram.h"
+#include <cmath> // For std::pow, std::log10, std::ceil
+
+namespace
+{
+    // BS.1770: loudness = -0.691 + 10 * log10(mean square energy)
+    double loudnessToEnergy (double lufs) { return std::pow(10.0, (lufs + 0.691) / 10.0); }
+    double energyToLoudness (double energy) { return -0.691 + 10.0 * std::log10(energy); }
+
+    constexpr double RELATIVE_GATE_LU = -20.0;       // Tech 3342 relative gate
+    constexpr double LOW_PERCENTILE = 0.10;
+    constexpr double HIGH_PERCENTILE = 0.95;
+}
+
+//==============================================================================
+LoudnessRangeHistogram::LoudnessRangeHistogram()
+{
+    reset();
+}
+
+void LoudnessRangeHistogram::reset()
+{
+    bins.fill(0);
+    gatedEnergySum = 0.0;
+    gatedCount = 0;
+
+    stage = Stage::Idle;
+    numPendingValues = 0;
+    lastLoudnessRange = 0.0f;
+}
+
+//==============================================================================
+void LoudnessRangeHistogram::addShortTermLoudness (double lufs)
+{
+    applyChange(lufs, false);
+}
+
+void LoudnessRangeHistogram::removeShortTermLoudness (double lufs)
+{
+    applyChange(lufs, true);
+}
+
+void LoudnessRangeHistogram::applyChange (double lufs, bool isRemoval)
+{
+    // Absolute gate (also drops -inf from silent windows)
+    if (! std::isfinite(lufs) || lufs < minLoudness)
+        return;
+
+    if (isEvaluating())
+    {
+        // Hold the change back so the running evaluation sees a fixed histogram
+        if (numPendingValues < maxPendingValues)
+        {
+            pendingValues[static_cast<size_t>(numPendingValues++)] = { lufs, isRemoval };
+            return;
+        }
+
+        // Nobody is driving the evaluation any more; finish it here
+        while (! continueEvaluation(numBins)) {}
+    }
+
+    if (isRemoval)
+        removeFromBins(lufs);
+    else
+        addToBins(lufs);
+}
+
+void LoudnessRangeHistogram::addToBins (double lufs)
+{
+    const int bin = juce::jlimit(0, numBins - 1, static_cast<int>((lufs - minLoudness) / binWidth));
+    ++bins[static_cast<size_t>(bin)];
+
+    gatedEnergySum += loudnessToEnergy(lufs);
+    ++gatedCount;
+}
+
+void LoudnessRangeHistogram::removeFromBins (double lufs)
+{
+    const int bin = juce::jlimit(0, numBins - 1, static_cast<int>((lufs - minLoudness) / binWidth));
+    auto& count = bins[static_cast<size_t>(bin)];
+    jassert(count > 0 && gatedCount > 0); // Only values that were added can be removed
+    if (count == 0 || gatedCount == 0)
+        return;
+
+    --count;
+    --gatedCount;
+    gatedEnergySum = (gatedCount > 0) ? juce::jmax(0.0, gatedEnergySum - loudnessToEnergy(lufs)) : 0.0;
+}
+
+//==============================================================================
+void LoudnessRangeHistogram::beginEvaluation()
+{
+    if (isEvaluating())
+        while (! continueEvaluation(numBins)) {}
+
+    if (gatedCount == 0)
+    {
+        finishEvaluation(0.0f);
+        return;
+    }
+
+    // Relative gate: 20 LU below the mean energy of the absolutely gated values
+    const double relativeGate = energyToLoudness(gatedEnergySum / static_cast<double>(gatedCount)) + RELATIVE_GATE_LU;
+    thresholdBin = juce::jlimit(0, numBins, static_cast<int>(std::ceil((relativeGate - minLoudness) / binWidth)));
+
+    stage = Stage::Counting;
+    cursor = thresholdBin;
+    countAboveGate = 0;
+}
+
+bool LoudnessRangeHistogram::continueEvaluation (int maxBins)
+{
+    if (stage == Stage::Idle)
+        return true;
+
+    int budget = juce::jmax(1, maxBins);
+
+    if (stage == Stage::Counting)
+    {
+        while (budget > 0 && cursor < numBins)
+        {
+            countAboveGate += bins[static_cast<size_t>(cursor++)];
+            --budget;
+        }
+
+        if (cursor < numBins)
+            return false;
+
+        if (countAboveGate == 0)
+        {
+            finishEvaluation(0.0f);
+            return true;
+        }
+
+        // Nearest-rank percentiles over the values that passed the relative gate
+        lowRank  = static_cast<juce::uint64>(static_cast<double>(countAboveGate - 1) * LOW_PERCENTILE + 0.5);
+        highRank = static_cast<juce::uint64>(static_cast<double>(countAboveGate - 1) * HIGH_PERCENTILE + 0.5);
+
+        stage = Stage::Percentiles;
+        cursor = thresholdBin;
+        cumulative = 0;
+        lowBin = -1;
+    }
+
+    while (budget > 0 && cursor < numBins)
+    {
+        cumulative += bins[static_cast<size_t>(cursor)];
+
+        if (lowBin < 0 && cumulative > lowRank)
+            lowBin = cursor;
+
+        if (cumulative > highRank)
+        {
+            finishEvaluation(static_cast<float>(getBinLoudness(cursor) - getBinLoudness(lowBin)));
+            return true;
+        }
+
+        ++cursor;
+        --budget;
+    }
+
+    if (cursor >= numBins)
+    {
+        jassertfalse; // highRank is always below countAboveGate
+        finishEvaluation(lastLoudnessRange);
+        return true;
+    }
+
+    return false;
+}
+
+void LoudnessRangeHistogram::finishEvaluation (float result)
+{
+    lastLoudnessRange = result;
+    stage = Stage::Idle;
+
+    for (int i = 0; i < numPendingValues; ++i)
+    {
+        const auto& change = pendingValues[static_cast<size_t>(i)];
+        if (change.isRemoval)
+            removeFromBins(change.lufs);
+        else
+            addToBins(change.lufs);
+    }
+
+    numPendingValues = 0;
+}
+
+float LoudnessRangeHistogram::computeLoudnessRange()
+{
+    beginEvaluation();
+    while (! continueEvaluation(numBins)) {}
+    return lastLoudnessRange;
+}
+
+//==============================================================================
+void LoudnessRangeHistogram::writeToStream (juce::OutputStream& output) const
+{
+    output.writeDouble(gatedEnergySum);
+    output.writeInt64(static_cast<juce::int64>(gatedCount));
+    output.writeFloat(lastLoudnessRange);
+
+    int numOccupied = 0;
+    for (const auto count : bins)
+        if (count != 0)
+            ++numOccupied;
+
+    // Occupied bins as (gap to the previous one, count)
+    output.writeCompressedInt(numOccupied);
+    int previousBin = -1;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const auto count = bins[static_cast<size_t>(bin)];
+        if (count == 0)
+            continue;
+
+        output.writeCompressedInt(bin - previousBin);
+        output.writeInt(static_cast<int>(count));
+        previousBin = bin;
+    }
+
+    output.writeCompressedInt(numPendingValues);
+    for (int i = 0; i < numPendingValues; ++i)
+    {
+        output.writeDouble(pendingValues[static_cast<size_t>(i)].lufs);
+        output.writeBool(pendingValues[static_cast<size_t>(i)].isRemoval);
+    }
+}
+
+bool LoudnessRangeHistogram::readFromStream (juce::InputStream& input)
+{
+    reset();
+    gatedEnergySum = input.readDouble();
+    gatedCount = static_cast<juce::uint64>(input.readInt64());
+    lastLoudnessRange = input.readFloat();
+
+    const int numOccupied = input.readCompressedInt();
+    bool isValid = (numOccupied >= 0 && numOccupied <= numBins);
+
+    int bin = -1;
+    for (int i = 0; isValid && i < numOccupied; ++i)
+    {
+        bin += input.readCompressedInt();
+        const int count = input.readInt();
+        isValid = juce::isPositiveAndBelow(bin, numBins) && count > 0;
+        if (isValid)
+            bins[static_cast<size_t>(bin)] = static_cast<juce::uint32>(count);
+    }
+
+    // Changes held back at the time of writing; nothing is evaluating now, so they go straight in
+    const int numPending = isValid ? input.readCompressedInt() : 0;
+    isValid = isValid && numPending >= 0 && numPending <= maxPendingValues;
+    for (int i = 0; isValid && i < numPending; ++i)
+    {
+        const double lufs = input.readDouble();
+        applyChange(lufs, input.readBool());
+    }
+
+    if (! isValid || ! std::isfinite(gatedEnergySum))
+    {
+        reset();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * Loudness Range (EBU Tech 3342) computed from a histogram of short-term values.
+ *
+ * Short-term loudness values are binned at 0.1 LU between -70 and +30 LUFS, so
+ * memory stays constant however long the measurement runs. The evaluation
+ * (relative gate, then the 10th and 95th percentiles) is resumable: it walks a
+ * bounded number of bins per call, and values added or removed while it is
+ * running are held back until it completes, so the result describes one
+ * consistent moment.
+ */
+class LoudnessRangeHistogram
+{
+public:
+    static constexpr double minLoudness = -70.0;          // Absolute gate, LUFS
+    static constexpr double maxLoudness = 30.0;           // Upper edge of the last bin, LUFS
+    static constexpr double binWidth = 0.1;               // LU per bin
+    static constexpr int numBins = 1000;
+    static constexpr int maxPendingValues = 256;          // Changes held back during an evaluation (25.6 s at 10 Hz)
+
+    LoudnessRangeHistogram();
+
+    /** Empties the histogram and abandons any evaluation in progress. */
+    void reset();
+
+    /** Adds one short-term loudness value in LUFS. Values below the absolute gate are ignored. */
+    void addShortTermLoudness (double lufs);
+
+    /**
+     * Takes back a value added earlier (pass exactly the same value), so a
+     * re-measured stretch of audio can replace its old values.
+     */
+    void removeShortTermLoudness (double lufs);
+
+    /** Starts evaluating the values added so far. Finishes a running evaluation first. */
+    void beginEvaluation();
+
+    /**
+     * Walks at most maxBins histogram bins of the running evaluation.
+     * @return true once no evaluation is running (the result is then up to date)
+     */
+    bool continueEvaluation (int maxBins);
+
+    /** True between beginEvaluation() and the continueEvaluation() call that completes it. */
+    bool isEvaluating() const noexcept { return stage != Stage::Idle; }
+
+    /** LRA from the last completed evaluation, in LU. */
+    float getLoudnessRange() const noexcept { return lastLoudnessRange; }
+
+    /** Runs a complete evaluation in one go and returns it. */
+    float computeLoudnessRange();
+
+    /**
+     * Writes the histogram, including changes held back by a running
+     * evaluation. Only occupied bins are written (a few hundred bytes for
+     * typical programme), whatever the length of the measurement.
+     */
+    void writeToStream (juce::OutputStream& output) const;
+
+    /**
+     * Replaces the contents with a histogram written by writeToStream().
+     * Returns false, leaving the histogram empty, if the data is damaged.
+     */
+    bool readFromStream (juce::InputStream& input);
+
+private:
+    enum class Stage { Idle, Counting, Percentiles };
+
+    void applyChange (double lufs, bool isRemoval);
+    void addToBins (double lufs);
+    void removeFromBins (double lufs);
+    void finishEvaluation (float result);
+
+    static double getBinLoudness (int bin) noexcept { return minLoudness + (bin + 0.5) * binWidth; }
+
+    // Histogram and the exact energy sum used by the relative gate
+    std::array<juce::uint32, numBins> bins;
+    double gatedEnergySum = 0.0;
+    juce::uint64 gatedCount = 0;
+
+    // Resumable evaluation state
+    Stage stage = Stage::Idle;
+    int cursor = 0;                         // Next bin to visit in the current stage
+    int thresholdBin = 0;                   // First bin at or above the relative gate
+    juce::uint64 countAboveGate = 0;        // Values at or above the relative gate
+    juce::uint64 lowRank = 0;               // Rank of the 10th percentile
+    juce::uint64 highRank = 0;              // Rank of the 95th percentile
+    juce::uint64 cumulative = 0;            // Values passed so far in the percentile walk
+    int lowBin = -1;                        // Bin holding the 10th percentile, once found
+    float lastLoudnessRange = 0.0f;
+
+    // Changes that arrived during an evaluation
+    struct PendingChange
+    {
+        double lufs;
+        bool isRemoval;
+    };
+    std::array<PendingChange, maxPendingValues> pendingValues;
+    int numPendingValues = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessRangeHistogram)
+};
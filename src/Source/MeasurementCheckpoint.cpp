@@ -0,0 +1,313 @@
+#include "MeasurementCheckpoint.h"
+#include <cstring> // For std::memcpy
+
+namespace
+{
+    constexpr juce::int32 checkpointMagic = 0x70634444;     // "DDcp"
+    constexpr juce::int32 checkpointVersion = 1;
+    constexpr int numSlots = 2;
+}
+
+//==============================================================================
+CheckpointWriter::CheckpointWriter()
+    : juce::Thread ("DynamicsDoctor checkpoints")
+{
+    // Checkpoints nobody came back for
+    const auto cutoff = juce::Time::currentTimeMillis() - static_cast<juce::int64>(staleDays) * 24 * 60 * 60 * 1000;
+    for (const auto& file : getDirectory().findChildFiles(juce::File::findFiles, false, "*.ddcp"))
+        if (file.getLastModificationTime().toMilliseconds() < cutoff)
+            file.deleteFile();
+
+    startThread(juce::Thread::Priority::background);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    stopThread(2000);
+}
+
+void CheckpointWriter::registerClient (CheckpointClient& client)
+{
+    const juce::ScopedLock sl (clientLock);
+    clients.addIfNotAlreadyThere(&client);
+}
+
+void CheckpointWriter::unregisterClient (CheckpointClient& client)
+{
+    const juce::ScopedLock sl (clientLock);
+    clients.removeFirstMatchingValue(&client);
+}
+
+bool CheckpointWriter::claimId (const juce::String& newId)
+{
+    const juce::ScopedLock sl (idLock);
+    if (newId.isEmpty() || idsInUse.contains(newId))
+        return false;
+
+    idsInUse.add(newId);
+    return true;
+}
+
+void CheckpointWriter::releaseId (const juce::String& oldId)
+{
+    const juce::ScopedLock sl (idLock);
+    idsInUse.removeString(oldId);
+}
+
+juce::File CheckpointWriter::getDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("DynamicsDoctor")
+               .getChildFile("Checkpoints");
+}
+
+void CheckpointWriter::run()
+{
+    while (! threadShouldExit())
+    {
+        wait(intervalMs);
+        if (threadShouldExit())
+            break;
+
+        // Clients are written one after the other; each only copies its history
+        // out under a try-lock, so nobody else ever waits for this thread
+        const juce::ScopedLock sl (clientLock);
+        for (auto* client : clients)
+            client->writeCheckpoint();
+    }
+}
+
+//==============================================================================
+struct MeasurementCheckpoint::FileHeader
+{
+    juce::int32 magic;
+    juce::int32 version;
+    juce::int64 slotCapacity;
+};
+
+struct MeasurementCheckpoint::SlotHeader
+{
+    juce::int64 sequence;                           // 0 while the slot is being written
+    juce::int64 wallTimeMs;
+    juce::int64 payloadSize;
+    juce::uint32 checksum;
+    juce::uint32 reserved;
+};
+
+MeasurementCheckpoint::MeasurementCheckpoint (CheckpointWriter& w)
+    : writer (w)
+{
+    do
+        id = juce::Uuid().toString();
+    while (! writer.claimId(id));
+}
+
+MeasurementCheckpoint::~MeasurementCheckpoint()
+{
+    {
+        const juce::ScopedLock sl (fileLock);
+        mapping.reset();
+    }
+
+    // Outside fileLock: the writer thread takes fileLock while it holds its own locks
+    writer.releaseId(id);
+}
+
+juce::String MeasurementCheckpoint::getId() const
+{
+    const juce::ScopedLock sl (fileLock);
+    return id;
+}
+
+juce::File MeasurementCheckpoint::getFile() const
+{
+    return CheckpointWriter::getDirectory().getChildFile(id + ".ddcp");
+}
+
+bool MeasurementCheckpoint::adoptId (const juce::String& savedId)
+{
+    // The id only changes on the message thread, so it can be read here without fileLock
+    if (savedId == id)
+        return true;
+
+    // Claimed and released outside fileLock: the writer thread takes fileLock
+    // while it holds its own locks, so taking them the other way round could deadlock
+    if (! writer.claimId(savedId))
+        return false;
+
+    const auto oldId = id;
+    {
+        // Our own file goes: its measurement is being replaced by the loaded one
+        const juce::ScopedLock sl (fileLock);
+        mapping.reset();
+        getFile().deleteFile();
+
+        id = savedId;
+        slotCapacity = 0;
+        sequence = 0;
+    }
+
+    writer.releaseId(oldId);
+    return true;
+}
+
+juce::uint32 MeasurementCheckpoint::computeChecksum (const void* data, size_t size) noexcept
+{
+    // FNV-1a: catches a slot that was torn by a crash, which is all we need
+    auto hash = static_cast<juce::uint32>(2166136261u);
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+//==============================================================================
+bool MeasurementCheckpoint::openMapping (size_t minCapacity)
+{
+    if (mapping != nullptr && slotCapacity >= minCapacity)
+        return true;
+
+    const auto file = getFile();
+    mapping.reset();
+
+    // Keep an existing file whose slots are big enough (e.g. the one a crash left)
+    if (file.existsAsFile())
+    {
+        mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite);
+        FileHeader header {};
+        if (mapping->getData() != nullptr && mapping->getSize() >= sizeof(FileHeader))
+            std::memcpy(&header, mapping->getData(), sizeof(FileHeader));
+
+        const auto capacity = static_cast<size_t>(juce::jmax(static_cast<juce::int64>(0), header.slotCapacity));
+        if (header.magic == checkpointMagic && header.version == checkpointVersion && capacity >= minCapacity
+            && mapping->getSize() == sizeof(FileHeader) + numSlots * (sizeof(SlotHeader) + capacity))
+        {
+            slotCapacity = capacity;
+            sequence = 0;
+            for (int slot = 0; slot < numSlots; ++slot)
+            {
+                SlotHeader slotHeader;
+                std::memcpy(&slotHeader, static_cast<const char*>(mapping->getData()) + sizeof(FileHeader)
+                                             + static_cast<size_t>(slot) * (sizeof(SlotHeader) + capacity), sizeof(SlotHeader));
+                sequence = juce::jmax(sequence, slotHeader.sequence);
+            }
+            return true;
+        }
+
+        mapping.reset();
+    }
+
+    // New file, zeroed, with room to grow: a timeline history can reach a megabyte
+    auto capacity = initialCapacity;
+    while (capacity < minCapacity)
+        capacity *= 2;
+
+    file.getParentDirectory().createDirectory();
+    {
+        juce::FileOutputStream output (file);
+        if (! output.openedOk())
+            return false;
+
+        output.setPosition(0);
+        output.truncate();
+        const FileHeader header { checkpointMagic, checkpointVersion, static_cast<juce::int64>(capacity) };
+        output.write(&header, sizeof(header));
+        output.writeRepeatedByte(0, numSlots * (sizeof(SlotHeader) + capacity));
+    }
+
+    mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite);
+    if (mapping->getData() == nullptr)
+    {
+        mapping.reset();
+        return false;
+    }
+
+    slotCapacity = capacity;
+    sequence = 0;
+    return true;
+}
+
+bool MeasurementCheckpoint::write (const juce::MemoryBlock& payload, juce::int64 wallTimeMs)
+{
+    const juce::ScopedLock sl (fileLock);
+
+    // Nothing to clear if no checkpoint was ever written
+    if (payload.isEmpty() && mapping == nullptr && ! getFile().existsAsFile())
+        return true;
+
+    if (! openMapping(payload.getSize()))
+        return false;
+
+    // The older slot; the newer one stays intact until this one is complete
+    const auto slot = static_cast<size_t>((sequence + 1) % numSlots);
+    auto* slotStart = static_cast<char*>(mapping->getData()) + sizeof(FileHeader) + slot * (sizeof(SlotHeader) + slotCapacity);
+
+    SlotHeader header {};
+    std::memcpy(slotStart, &header, sizeof(SlotHeader));
+    if (! payload.isEmpty())
+        std::memcpy(slotStart + sizeof(SlotHeader), payload.getData(), payload.getSize());
+
+    header.wallTimeMs = wallTimeMs;
+    header.payloadSize = static_cast<juce::int64>(payload.getSize());
+    header.checksum = computeChecksum(payload.getData(), payload.getSize());
+    std::memcpy(slotStart, &header, sizeof(SlotHeader));
+
+    // The sequence number goes in last and makes the slot valid
+    header.sequence = ++sequence;
+    std::memcpy(slotStart, &header.sequence, sizeof(header.sequence));
+    return true;
+}
+
+bool MeasurementCheckpoint::read (juce::MemoryBlock& payload, juce::int64& wallTimeMs) const
+{
+    const juce::ScopedLock sl (fileLock);
+    const auto file = getFile();
+    if (! file.existsAsFile())
+        return false;
+
+    const juce::MemoryMappedFile source (file, juce::MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const char*>(source.getData());
+    if (data == nullptr || source.getSize() < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(FileHeader));
+    const auto capacity = static_cast<size_t>(juce::jmax(static_cast<juce::int64>(0), header.slotCapacity));
+    if (header.magic != checkpointMagic || header.version != checkpointVersion
+        || source.getSize() != sizeof(FileHeader) + numSlots * (sizeof(SlotHeader) + capacity))
+        return false;
+
+    // Newest slot that was completely written
+    const char* newest = nullptr;
+    SlotHeader newestHeader {};
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        const auto* slotStart = data + sizeof(FileHeader) + static_cast<size_t>(slot) * (sizeof(SlotHeader) + capacity);
+        SlotHeader slotHeader;
+        std::memcpy(&slotHeader, slotStart, sizeof(SlotHeader));
+
+        if (slotHeader.sequence <= newestHeader.sequence
+            || ! juce::isPositiveAndNotGreaterThan(slotHeader.payloadSize, static_cast<juce::int64>(capacity))
+            || computeChecksum(slotStart + sizeof(SlotHeader), static_cast<size_t>(slotHeader.payloadSize)) != slotHeader.checksum)
+            continue;
+
+        newest = slotStart;
+        newestHeader = slotHeader;
+    }
+
+    if (newest == nullptr)
+        return false;
+
+    payload.replaceAll(newest + sizeof(SlotHeader), static_cast<size_t>(newestHeader.payloadSize));
+    wallTimeMs = newestHeader.wallTimeMs;
+    return true;
+}
+
+void MeasurementCheckpoint::remove()
+{
+    const juce::ScopedLock sl (fileLock);
+    mapping.reset();
+    getFile().deleteFile();
+    slotCapacity = 0;
+    sequence = 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+
+class CheckpointWriter;
+
+//==============================================================================
+/**
+ * Interface for an instance whose measurement is checkpointed by the shared
+ * CheckpointWriter.
+ */
+class CheckpointClient
+{
+public:
+    virtual ~CheckpointClient() = default;
+
+    /**
+     * Called on the writer's background thread every CheckpointWriter::intervalMs.
+     * Must never wait for the audio or analysis side; skipping a turn is fine.
+     */
+    virtual void writeCheckpoint() = 0;
+};
+
+//==============================================================================
+/**
+ * Process-wide low-priority thread that asks every registered instance to
+ * checkpoint its measurement (through juce::SharedResourcePointer). It also
+ * hands out checkpoint ids, so that two instances loaded from the same state
+ * never write the same file, and clears out files left by old crashes.
+ */
+class CheckpointWriter : private juce::Thread
+{
+public:
+    static constexpr int intervalMs = 10000;        // Time between checkpoints of one instance
+    static constexpr int staleDays = 7;             // Files older than this are deleted at start-up
+
+    CheckpointWriter();
+    ~CheckpointWriter() override;
+
+    /** Adds a client. Call from the message thread. */
+    void registerClient (CheckpointClient& client);
+
+    /** Removes a client; blocks until the writer is no longer inside it. */
+    void unregisterClient (CheckpointClient& client);
+
+    /** Reserves a checkpoint id for one instance. Returns false if another instance holds it. */
+    bool claimId (const juce::String& id);
+    void releaseId (const juce::String& id);
+
+    /** <user application data>/DynamicsDoctor/Checkpoints */
+    static juce::File getDirectory();
+
+private:
+    void run() override;
+
+    juce::CriticalSection clientLock;               // Held while a client is being written
+    juce::Array<CheckpointClient*> clients;
+    juce::CriticalSection idLock;                   // Guards idsInUse only; nothing is called while it is held
+    juce::StringArray idsInUse;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CheckpointWriter)
+};
+
+//==============================================================================
+/**
+ * One instance's crash checkpoint: the latest measurement snapshot in a
+ * memory-mapped file, so a host or plugin crash loses at most one interval.
+ *
+ * The file holds two slots. Each write goes to the older slot and stamps it
+ * with a sequence number and checksum only once the payload is in place, so
+ * a crash mid-write leaves the other slot as the valid one. Writes are a
+ * memcpy into the mapping; the OS writes the pages out in its own time (a
+ * power cut may lose the last checkpoint, a crashed process does not).
+ *
+ * An empty payload marks "no finished measurement" (e.g. after a reset).
+ * The file is deleted by remove() when the instance closes normally, so only
+ * a crash leaves one behind.
+ */
+class MeasurementCheckpoint
+{
+public:
+    /** Claims a fresh id; nothing is written until the first non-empty write(). */
+    explicit MeasurementCheckpoint (CheckpointWriter& writer);
+    ~MeasurementCheckpoint();
+
+    /** Id saved with the plugin state, to find the checkpoint again after a crash. */
+    juce::String getId() const;
+
+    /**
+     * Takes over the id of a saved state, and with it any checkpoint left
+     * behind. Returns false (keeping the current id) if another instance of
+     * this process already uses it. Call from the message thread.
+     */
+    bool adoptId (const juce::String& savedId);
+
+    /** Stores a payload in the older slot. Writer thread. */
+    bool write (const juce::MemoryBlock& payload, juce::int64 wallTimeMs);
+
+    /** Latest intact payload and the time it was written. False if there is no checkpoint. */
+    bool read (juce::MemoryBlock& payload, juce::int64& wallTimeMs) const;
+
+    /** Closes and deletes the checkpoint file. */
+    void remove();
+
+private:
+    struct FileHeader;
+    struct SlotHeader;
+
+    juce::File getFile() const;
+
+    /** Maps the file with room for payloads of minCapacity bytes, creating or growing it if needed. */
+    bool openMapping (size_t minCapacity);
+
+    static juce::uint32 computeChecksum (const void* data, size_t size) noexcept;
+
+    CheckpointWriter& writer;
+    juce::String id;
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    size_t slotCapacity = 0;
+    juce::int64 sequence = 0;                       // Of the newest slot in the mapped file
+    juce::CriticalSection fileLock;                 // Writer thread against id changes and removal
+
+    static constexpr size_t initialCapacity = 64 * 1024;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeasurementCheckpoint)
+};
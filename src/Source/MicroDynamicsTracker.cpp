@@ -0,0 +1,112 @@
+#include "MicroDynamicsTracker.h"
+#include <cmath>     // For std::abs, std::sqrt, std::isfinite
+#include <algorithm> // For std::fill
+
+//==============================================================================
+bool MicroDynamicsTracker::Summary::isBelowMinimum (const DynamicsPreset& preset) const noexcept
+{
+    if (! isAvailable)
+        return false;
+
+    return (preset.minPSR > 0.0f && psr < preset.minPSR)
+        || (preset.minPLR > 0.0f && plr < preset.minPLR);
+}
+
+juce::String MicroDynamicsTracker::Summary::describe (const DynamicsPreset& preset) const
+{
+    if (! isAvailable)
+        return "Micro-dynamics: waiting for a full short-term window";
+
+    auto minimum = [] (float value) { return value > 0.0f ? " (minimum " + juce::String(value, 1) + ")" : juce::String(); };
+
+    juce::String text;
+    text << "PSR: " << juce::String(psr, 1) << " dB" << minimum(preset.minPSR)
+         << ", lowest " << juce::String(lowestPsr, 1) << " dB\n"
+         << "PLR: " << juce::String(plr, 1) << " dB" << minimum(preset.minPLR) << "\n"
+         << "Crest factor: " << juce::String(crestFactor, 1) << " dB\n"
+         << "Peak: " << juce::String(maxPeakDb, 1) << " dBFS";
+    return text;
+}
+
+//==============================================================================
+MicroDynamicsTracker::MicroDynamicsTracker()
+    : window (windowHops)
+{
+}
+
+void MicroDynamicsTracker::reset()
+{
+    hopPeak = 0.0f;
+    hopSquares = 0.0;
+    hopSamples = 0;
+    std::fill(window.begin(), window.end(), Hop());
+    windowPosition = 0;
+
+    maxPeak = 0.0f;
+    lastPsr = lowestPsr = lastCrest = 0.0f;
+    hasPsr = false;
+}
+
+void MicroDynamicsTracker::process (const float* interleavedData, int numFrames, int numChannels) noexcept
+{
+    const int numSamples = numFrames * numChannels;
+    float peak = hopPeak;
+    double squares = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float x = interleavedData[i];
+        peak = juce::jmax(peak, std::abs(x));
+        squares += static_cast<double>(x) * x;
+    }
+
+    hopPeak = peak;
+    hopSquares += squares;
+    hopSamples += numSamples;
+}
+
+void MicroDynamicsTracker::finishHop (double shortTermLufs)
+{
+    window[static_cast<size_t>(windowPosition)] = { hopPeak, hopSquares, hopSamples };
+    windowPosition = (windowPosition + 1) % windowHops;
+    maxPeak = juce::jmax(maxPeak, hopPeak);
+    hopPeak = 0.0f;
+    hopSquares = 0.0;
+    hopSamples = 0;
+
+    if (! std::isfinite(shortTermLufs))
+        return;
+
+    float windowPeak = 0.0f;
+    double windowSquares = 0.0;
+    juce::int64 windowSamples = 0;
+    for (const auto& hop : window)
+    {
+        windowPeak = juce::jmax(windowPeak, hop.peak);
+        windowSquares += hop.squares;
+        windowSamples += hop.samples;
+    }
+
+    if (windowPeak <= 0.0f || windowSquares <= 0.0 || windowSamples == 0)
+        return;
+
+    const float windowPeakDb = juce::Decibels::gainToDecibels(windowPeak);
+    const float windowRms = static_cast<float>(std::sqrt(windowSquares / static_cast<double>(windowSamples)));
+
+    lastPsr = windowPeakDb - static_cast<float>(shortTermLufs);
+    lowestPsr = hasPsr ? juce::jmin(lowestPsr, lastPsr) : lastPsr;
+    lastCrest = windowPeakDb - juce::Decibels::gainToDecibels(windowRms);
+    hasPsr = true;
+}
+
+MicroDynamicsTracker::Summary MicroDynamicsTracker::getSummary (double integratedLufs) const
+{
+    Summary summary;
+    summary.isAvailable = hasPsr;
+    summary.psr = lastPsr;
+    summary.lowestPsr = lowestPsr;
+    summary.crestFactor = lastCrest;
+    summary.maxPeakDb = juce::Decibels::gainToDecibels(maxPeak);
+    summary.plr = std::isfinite(integratedLufs) ? summary.maxPeakDb - static_cast<float>(integratedLufs) : 0.0f;
+    return summary;
+}
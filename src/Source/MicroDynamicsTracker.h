@@ -0,0 +1,78 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h> // For juce::Decibels
+#include <vector>
+
+#include "Constants.h" // For DynamicsPreset
+
+//==============================================================================
+/**
+ * Micro-dynamics next to the LRA: peak-to-short-term loudness ratio (PSR),
+ * peak-to-loudness ratio (PLR) and crest factor. LRA moves over seconds;
+ * over-limiting shows up here first.
+ *
+ * The meter hands over each run of interleaved frames it feeds libebur128
+ * (process(), one max and one multiply-add per sample) and closes every
+ * 100 ms hop with the short-term loudness of the same moment (finishHop()).
+ * Peaks and energy are kept per hop over the 3 s short-term window, so PSR
+ * and crest factor describe exactly the audio the short-term value does.
+ *
+ * Peaks are sample peaks at the meter's rate, like the plugin's peak meter.
+ */
+class MicroDynamicsTracker
+{
+public:
+    static constexpr int windowHops = 30;                   // 3 s short-term window in 100 ms hops
+
+    /** Values as published to the editor and the reports, in dB. */
+    struct Summary
+    {
+        bool isAvailable = false;
+        float psr = 0.0f;                                   // Window peak minus short-term loudness
+        float lowestPsr = 0.0f;                             // Lowest PSR since reset
+        float plr = 0.0f;                                   // Peak since reset minus integrated loudness
+        float crestFactor = 0.0f;                           // Window peak over window RMS
+        float maxPeakDb = -100.0f;                          // dBFS since reset
+
+        /** True if PSR or PLR is below a preset's minimum (minimums of 0 are not checked). */
+        bool isBelowMinimum (const DynamicsPreset& preset) const noexcept;
+
+        /** One line per value, with the preset's minimums. */
+        juce::String describe (const DynamicsPreset& preset) const;
+    };
+
+    MicroDynamicsTracker();
+
+    /** Clears the window and everything since reset. */
+    void reset();
+
+    /** Adds interleaved frames to the current hop. */
+    void process (const float* interleavedData, int numFrames, int numChannels) noexcept;
+
+    /**
+     * Closes the current hop. With a finite short-term loudness (a full
+     * window) a new PSR is taken.
+     */
+    void finishHop (double shortTermLufs);
+
+    /** Summary with PLR against an integrated loudness in LUFS. */
+    Summary getSummary (double integratedLufs) const;
+
+private:
+    float hopPeak = 0.0f;                                   // Absolute sample peak in the current hop
+    double hopSquares = 0.0;                                // Sum of squares in the current hop
+    juce::int64 hopSamples = 0;                             // Samples (frames x channels) in the current hop
+
+    struct Hop
+    {
+        float peak = 0.0f;
+        double squares = 0.0;
+        juce::int64 samples = 0;
+    };
+    std::vector<Hop> window;                                // Last windowHops hops
+    int windowPosition = 0;
+
+    float maxPeak = 0.0f;                                   // Since reset
+    float lastPsr = 0.0f, lowestPsr = 0.0f, lastCrest = 0.0f;
+    bool hasPsr = false;
+};
@@ -0,0 +1,238 @@
+#include "MultibandLoudness.h"
+#include <cmath>     // For std::tan, std::pow, std::log10
+#include <limits>    // For std::numeric_limits
+#include <algorithm> // For std::fill
+
+namespace
+{
+    constexpr double lowCrossoverHz = 150.0;
+    constexpr double midCrossoverHz = 800.0;
+    constexpr double highCrossoverHz = 4000.0;
+}
+
+//==============================================================================
+juce::String MultibandLoudness::getBandName (int band)
+{
+    switch (band)
+    {
+        case 0:  return "Low (< 150 Hz)";
+        case 1:  return "Low mid (150-800 Hz)";
+        case 2:  return "High mid (800 Hz-4 kHz)";
+        case 3:  return "High (> 4 kHz)";
+        default: return "Band " + juce::String(band + 1);
+    }
+}
+
+int MultibandLoudness::Summary::getLeastDynamicBand() const noexcept
+{
+    if (! isAvailable)
+        return -1;
+
+    int least = 0;
+    for (int band = 1; band < numBands; ++band)
+        if (lra[static_cast<size_t>(band)] < lra[static_cast<size_t>(least)])
+            least = band;
+    return least;
+}
+
+juce::String MultibandLoudness::Summary::describe (float fullBandLRA) const
+{
+    if (! isAvailable)
+        return "Band analysis off";
+
+    juce::String text;
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float shortTerm = shortTermLUFS[static_cast<size_t>(band)];
+        text << getBandName(band) << ": LRA " << juce::String(lra[static_cast<size_t>(band)], 1) << " LU, short-term "
+             << (std::isfinite(shortTerm) ? juce::String(shortTerm, 1) + " LUFS" : juce::String("---")) << "\n";
+    }
+
+    const int least = getLeastDynamicBand();
+    text << "Least dynamic: " << getBandName(least) << ", "
+         << juce::String(fullBandLRA - lra[static_cast<size_t>(least)], 1) << " LU below the full-band LRA";
+    return text;
+}
+
+//==============================================================================
+MultibandLoudness::Biquad MultibandLoudness::makeButterworth (double sampleRate, double cutoffHz, bool isHighPass)
+{
+    // Bilinear transform of a 2nd-order Butterworth; two in series make a Linkwitz-Riley
+    const double k = std::tan(juce::MathConstants<double>::pi * juce::jmin(cutoffHz, 0.45 * sampleRate) / sampleRate);
+    const double q = juce::MathConstants<double>::sqrt2 / 2.0;
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+
+    Biquad c;
+    c.b0 = static_cast<float>(isHighPass ? norm : k * k * norm);
+    c.b1 = static_cast<float>(isHighPass ? -2.0 * norm : 2.0 * k * k * norm);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) * norm);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) * norm);
+    return c;
+}
+
+void MultibandLoudness::prepare (double sampleRate, int newNumChannels)
+{
+    numChannels = juce::jmax(1, newNumChannels);
+
+    // K-weighting, with libebur128's constants so the bands agree with the broadband meter
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        auto& shelf = sections[kShelf];
+        shelf.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        shelf.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        shelf.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        shelf.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        shelf.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        auto& highPass = sections[kHighPass];
+        highPass.b0 = 1.0f;
+        highPass.b1 = -2.0f;
+        highPass.b2 = 1.0f;
+        highPass.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        highPass.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    const auto setCrossover = [this, sampleRate] (int lowA, double hz)
+    {
+        sections[static_cast<size_t>(lowA)] = sections[static_cast<size_t>(lowA + 1)] = makeButterworth(sampleRate, hz, false);
+        sections[static_cast<size_t>(lowA + 2)] = sections[static_cast<size_t>(lowA + 3)] = makeButterworth(sampleRate, hz, true);
+    };
+    setCrossover(split1LowA, midCrossoverHz);
+    setCrossover(split0LowA, lowCrossoverHz);
+    setCrossover(split2LowA, highCrossoverHz);
+
+    states.assign(static_cast<size_t>(numChannels), {});
+    windowEnergy.assign(windowHops, {});
+    windowFrames.assign(windowHops, 0);
+    reset();
+}
+
+void MultibandLoudness::reset()
+{
+    for (auto& channel : states)
+        channel.fill({});
+
+    hopEnergy.fill(0.0);
+    hopFrames = 0;
+    for (auto& hop : windowEnergy)
+        hop.fill(0.0);
+    std::fill(windowFrames.begin(), windowFrames.end(), 0);
+    windowPosition = 0;
+
+    shortTermLUFS.fill(-std::numeric_limits<float>::infinity());
+    for (auto& histogram : histograms)
+        histogram.reset();
+}
+
+//==============================================================================
+void MultibandLoudness::process (const float* interleavedData, int numFrames)
+{
+    if (states.empty())
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& s = states[static_cast<size_t>(ch)];
+        const auto& c = sections;
+        double e0 = 0.0, e1 = 0.0, e2 = 0.0, e3 = 0.0;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            const float x = s[kHighPass].process(c[kHighPass], s[kShelf].process(c[kShelf], interleavedData[i * numChannels + ch]));
+
+            const float low = s[split1LowB].process(c[split1LowB], s[split1LowA].process(c[split1LowA], x));
+            const float high = s[split1HighB].process(c[split1HighB], s[split1HighA].process(c[split1HighA], x));
+
+            const float band0 = s[split0LowB].process(c[split0LowB], s[split0LowA].process(c[split0LowA], low));
+            const float band1 = s[split0HighB].process(c[split0HighB], s[split0HighA].process(c[split0HighA], low));
+            const float band2 = s[split2LowB].process(c[split2LowB], s[split2LowA].process(c[split2LowA], high));
+            const float band3 = s[split2HighB].process(c[split2HighB], s[split2HighA].process(c[split2HighA], high));
+
+            e0 += band0 * band0;
+            e1 += band1 * band1;
+            e2 += band2 * band2;
+            e3 += band3 * band3;
+        }
+
+        hopEnergy[0] += e0;
+        hopEnergy[1] += e1;
+        hopEnergy[2] += e2;
+        hopEnergy[3] += e3;
+    }
+
+    hopFrames += numFrames;
+}
+
+void MultibandLoudness::finishHop (bool takeValue)
+{
+    if (windowEnergy.empty())
+        return;
+
+    windowEnergy[static_cast<size_t>(windowPosition)] = hopEnergy;
+    windowFrames[static_cast<size_t>(windowPosition)] = hopFrames;
+    windowPosition = (windowPosition + 1) % windowHops;
+    hopEnergy.fill(0.0);
+    hopFrames = 0;
+
+    if (! takeValue)
+        return;
+
+    int frames = 0;
+    for (const int hop : windowFrames)
+        frames += hop;
+    if (frames <= 0)
+        return;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        double energy = 0.0;
+        for (const auto& hop : windowEnergy)
+            energy += hop[static_cast<size_t>(band)];
+
+        // BS.1770: -0.691 + 10 log10 of the channel-summed mean square
+        const double lufs = (energy > 0.0) ? -0.691 + 10.0 * std::log10(energy / frames)
+                                           : -std::numeric_limits<double>::infinity();
+        shortTermLUFS[static_cast<size_t>(band)] = static_cast<float>(lufs);
+        histograms[static_cast<size_t>(band)].addShortTermLoudness(lufs);
+    }
+}
+
+float MultibandLoudness::computeLoudnessRange (int band)
+{
+    if (! juce::isPositiveAndBelow(band, numBands))
+        return 0.0f;
+
+    return histograms[static_cast<size_t>(band)].computeLoudnessRange();
+}
+
+void MultibandLoudness::writeHistograms (juce::OutputStream& output) const
+{
+    for (const auto& histogram : histograms)
+        histogram.writeToStream(output);
+}
+
+bool MultibandLoudness::readHistograms (juce::InputStream& input)
+{
+    for (auto& histogram : histograms)
+    {
+        if (! histogram.readFromStream(input))
+        {
+            for (auto& h : histograms)
+                h.reset();
+            return false;
+        }
+    }
+
+    return true;
+}
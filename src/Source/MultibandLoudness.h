@@ -0,0 +1,115 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+#include "LoudnessRangeHistogram.h"
+
+//==============================================================================
+/**
+ * Short-term loudness and Loudness Range per frequency band, to tell whether
+ * it's the low end, the vocals or the top that has lost its dynamics.
+ *
+ * The audio is K-weighted once (the BS.1770 pre-filter and RLB high-pass,
+ * designed the same way as libebur128's) and split into four bands by a tree
+ * of 4th-order Linkwitz-Riley crossovers. Each band gets the 100 ms / 3 s
+ * short-term gating of the broadband meter and its own LoudnessRangeHistogram.
+ * The work per sample is a fixed fourteen biquads per channel, whatever the
+ * programme; channels are weighted equally.
+ *
+ * The meter calls process() for the audio of each hop and finishHop() on
+ * every 100 ms boundary, so band values line up with the broadband ones.
+ */
+class MultibandLoudness
+{
+public:
+    static constexpr int numBands = 4;
+    static constexpr int windowHops = 30;                   // 3 s short-term window in 100 ms hops
+
+    /** Band name with its frequency range, e.g. "Low mid (150-800 Hz)". */
+    static juce::String getBandName (int band);
+
+    /** Per-band results as published to the editor and the reports. */
+    struct Summary
+    {
+        bool isAvailable = false;
+        std::array<float, numBands> lra {};                 // LU
+        std::array<float, numBands> shortTermLUFS {};       // Latest short-term value
+
+        /** Band with the smallest LRA, or -1 if not available. */
+        int getLeastDynamicBand() const noexcept;
+
+        /** One line per band plus the least dynamic band, relative to the full-band LRA. */
+        juce::String describe (float fullBandLRA) const;
+    };
+
+    /** Designs the filters for the meter rate. */
+    void prepare (double sampleRate, int numChannels);
+
+    /** Clears the filters, the window and the histograms. */
+    void reset();
+
+    /** Filters interleaved frames and adds their energy to the current hop. */
+    void process (const float* interleavedData, int numFrames);
+
+    /**
+     * Closes the current hop. With takeValue true each band's short-term
+     * loudness goes into its histogram (false while the window is refilling).
+     */
+    void finishHop (bool takeValue);
+
+    /** Latest short-term loudness of a band in LUFS (-inf before the first value). */
+    float getShortTermLoudness (int band) const noexcept { return shortTermLUFS[static_cast<size_t>(band)]; }
+
+    /** Evaluates a band's whole histogram in one go (1000 bins). */
+    float computeLoudnessRange (int band);
+
+    /** Saves and restores the band histograms, for a measurement kept with the plugin state. */
+    void writeHistograms (juce::OutputStream& output) const;
+    bool readHistograms (juce::InputStream& input);
+
+private:
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    /** Filter sections in processing order (see process()). */
+    enum Section
+    {
+        kShelf, kHighPass,
+        split1LowA, split1LowB, split1HighA, split1HighB,   // Middle crossover
+        split0LowA, split0LowB, split0HighA, split0HighB,   // Lower crossover, on the low side
+        split2LowA, split2LowB, split2HighA, split2HighB,   // Upper crossover, on the high side
+        numSections
+    };
+
+    struct SectionState
+    {
+        float z1 = 0.0f, z2 = 0.0f;
+
+        float process (const Biquad& c, float x) noexcept
+        {
+            const float y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            return y;
+        }
+    };
+
+    static Biquad makeButterworth (double sampleRate, double cutoffHz, bool isHighPass);
+
+    std::array<Biquad, numSections> sections;
+    std::vector<std::array<SectionState, numSections>> states;  // Per channel
+    int numChannels = 0;
+
+    std::array<double, numBands> hopEnergy {};              // Sum of squares in the current hop
+    int hopFrames = 0;
+    std::vector<std::array<double, numBands>> windowEnergy; // Last windowHops hops
+    std::vector<int> windowFrames;
+    int windowPosition = 0;
+
+    std::array<float, numBands> shortTermLUFS {};
+    std::array<LoudnessRangeHistogram, numBands> histograms;
+};
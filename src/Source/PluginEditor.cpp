@@ -1,10 +1,11 @@
 #include "PluginProcessor.h" // Provides DynamicsDoctorProcessor
 #include "PluginEditor.h"    // Provides DynamicsDoctorEditor class declaration
-#include "Constants.h"       // Provides Palette, DynamicsStatus, presets, ParameterIDs, helpers
+#include "Constants.h"       // Provides Palette, DynamicsStatus, ParameterIDs, helpers
 
 //==============================================================================
 DynamicsDoctorEditor::DynamicsDoctorEditor (DynamicsDoctorProcessor& p, juce::AudioProcessorValueTreeState& vts)
-    : AudioProcessorEditor (&p), processorRef (p), valueTreeState (vts)
+    : AudioProcessorEditor (&p), processorRef (p), valueTreeState (vts),
+      sessionOverview (p.getSessionRegistry())
 {
     // Initialize and configure UI components
     addAndMakeVisible (trafficLight);
@@ -21,18 +22,27 @@ DynamicsDoctorEditor::DynamicsDoctorEditor (DynamicsDoctorProcessor& p, juce::Au
     presetLabel.attachToComponent(&presetSelector, true);
     addAndMakeVisible (presetLabel);
     
-    presetSelector.setTooltip ("Select the dynamic range reference standard");
-    presetSelector.clear();
-    for (int i = 0; i < presets.size(); ++i)
-    {
-        presetSelector.addItem (presets[i].label, i + 1);
-    }
     addAndMakeVisible (presetSelector);
     presetSelector.addListener (this);
 
-    // Connect preset selector to parameter
-    presetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        valueTreeState, ParameterIDs::preset.getParamID(), presetSelector);
+    // Item id == table index + 1; the timer follows the processor's selection
+    refreshPresetList();
+
+    // Configure LRA evaluation rate selector and label
+    rateLabel.setFont (juce::FontOptions(14.0f));
+    rateLabel.setJustificationType (juce::Justification::centredRight);
+    rateLabel.attachToComponent(&rateSelector, true);
+    addAndMakeVisible (rateLabel);
+
+    rateSelector.setTooltip ("How often LRA and the status are re-evaluated");
+    for (int i = 0; i < static_cast<int>(lraRates.size()); ++i)
+    {
+        rateSelector.addItem (lraRates[static_cast<size_t>(i)].label, i + 1);
+    }
+    addAndMakeVisible (rateSelector);
+
+    rateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        valueTreeState, ParameterIDs::lraRate.getParamID(), rateSelector);
 
     // Configure measurement value labels
     peakValueLabel.setFont (juce::FontOptions(12.0f));
@@ -50,6 +60,16 @@ DynamicsDoctorEditor::DynamicsDoctorEditor (DynamicsDoctorProcessor& p, juce::Au
     presetInfoLabel.setColour(juce::Label::textColourId, Palette::Foreground.withAlpha(0.7f));
     addAndMakeVisible (presetInfoLabel);
 
+    doseValueLabel.setFont (juce::FontOptions(12.0f));
+    doseValueLabel.setJustificationType (juce::Justification::centred);
+    doseValueLabel.setColour(juce::Label::textColourId, Palette::Foreground.withAlpha(0.7f));
+    addAndMakeVisible (doseValueLabel);
+
+    referenceValueLabel.setFont (juce::FontOptions(12.0f));
+    referenceValueLabel.setJustificationType (juce::Justification::centred);
+    referenceValueLabel.setColour(juce::Label::textColourId, Palette::Foreground.withAlpha(0.7f));
+    addAndMakeVisible (referenceValueLabel);
+
     // Configure LRA reset button
     resetLraButton.setTooltip("Reset the Loudness Range (LRA) measurement history");
     addAndMakeVisible(resetLraButton);
@@ -68,6 +88,16 @@ DynamicsDoctorEditor::DynamicsDoctorEditor (DynamicsDoctorProcessor& p, juce::Au
         }
     };
     
+    // Configure session overview (replaces the traffic light while shown)
+    sessionButton.setTooltip("Show every DynamicsDoctor instance in this session");
+    sessionButton.setClickingTogglesState(true);
+    sessionButton.onClick = [this]() { setSessionOverviewVisible(sessionButton.getToggleState()); };
+    addAndMakeVisible(sessionButton);
+
+    sessionViewport.setViewedComponent(&sessionOverview, false);
+    sessionViewport.setScrollBarsShown(true, false);
+    addChildComponent(sessionViewport);
+
     // Configure version label
     versionLabel.setText ("Build: " + juce::String(__DATE__) + " " + juce::String(__TIME__), juce::dontSendNotification);
     versionLabel.setFont(juce::FontOptions (10.0f));
@@ -75,8 +105,15 @@ DynamicsDoctorEditor::DynamicsDoctorEditor (DynamicsDoctorProcessor& p, juce::Au
     versionLabel.setColour(juce::Label::textColourId, Palette::Foreground.withAlpha(0.6f));
     addAndMakeVisible(versionLabel);
 
+    // Configure timing summary (cost of processBlock against the block deadline)
+    timingButton.setTooltip("Audio callback cost as a share of the block duration. Click to save a session report.");
+    timingButton.setColour(juce::TextButton::buttonColourId, juce::Colours::transparentBlack);
+    timingButton.setColour(juce::TextButton::textColourOffId, Palette::Foreground.withAlpha(0.6f));
+    timingButton.onClick = [this]() { showTimingMenu(); };
+    addAndMakeVisible(timingButton);
+
     // Set editor size and start UI update timer
-    setSize (250, 430);
+    setSize (250, 470);
     startTimerHz (15);
     updateUIStatus();
 }
@@ -85,12 +122,13 @@ DynamicsDoctorEditor::~DynamicsDoctorEditor()
 {
     // Stop the timer safely
     stopTimer();
+    processorRef.setEditorShowing(false);
 
     // Remove listeners explicitly added
     presetSelector.removeListener(this);
     resetLraButton.removeListener(this);
     
-    // Attachments (`presetAttachment`) are automatically cleaned up
+    // Attachments are automatically cleaned up
     // by their std::unique_ptr destructors.
 }
 
@@ -129,6 +167,10 @@ void DynamicsDoctorEditor::resized()
     auto bounds = getLocalBounds().reduced(padding);
     auto topArea = bounds.removeFromTop(bounds.getHeight() * 0.50f);
     
+    // Session overview shares the status and traffic light area
+    sessionViewport.setBounds(topArea);
+    sessionOverview.setSize(sessionViewport.getMaximumVisibleWidth(), sessionOverview.getHeight());
+
     // Position status label and traffic light
     statusLabel.setBounds(topArea.removeFromTop(topSectionHeight));
     trafficLight.setBounds(topArea.reduced(10));
@@ -139,30 +181,85 @@ void DynamicsDoctorEditor::resized()
     versionLabel.setBounds(bottomArea.removeFromBottom(versionAreaHeight).reduced(0, padding / 2));
     
     auto resetButtonArea = bottomArea.removeFromBottom(buttonRowHeight + controlGap);
-    auto infoArea = bottomArea.removeFromBottom(valueLabelHeight * 3 + 10);
+    auto infoArea = bottomArea.removeFromBottom(valueLabelHeight * 5 + 10);
     auto controlArea = bottomArea;
 
-    // Position reset button
-    resetLraButton.setBounds(resetButtonArea.reduced(controlArea.getWidth() * 0.2f, 0));
+    // Position reset and session buttons side by side
+    auto buttonRow = resetButtonArea.reduced(controlArea.getWidth() * 0.1f, 0);
+    resetLraButton.setBounds(buttonRow.removeFromLeft(buttonRow.getWidth() / 2).reduced(controlGap, 0));
+    sessionButton.setBounds(buttonRow.reduced(controlGap, 0));
     
     // Position controls
     controlArea.reduce(10, 5);
-    controlArea.removeFromTop(20);
+    controlArea.removeFromTop(15);
     auto presetRow = controlArea.removeFromTop(controlHeight);
     presetSelector.setBounds(presetRow.withLeft(presetRow.getX() + labelWidth).reduced(5, 0));
+    controlArea.removeFromTop(controlGap);
+    auto rateRow = controlArea.removeFromTop(controlHeight);
+    rateSelector.setBounds(rateRow.withLeft(rateRow.getX() + labelWidth).reduced(5, 0));
 
     // Position measurement labels
     infoArea.reduce(0, 5);
     auto peakArea = infoArea.removeFromTop(valueLabelHeight);
     auto lraDisplayArea = infoArea.removeFromTop(valueLabelHeight);
+    auto referenceArea = infoArea.removeFromTop(valueLabelHeight);
+    auto doseArea = infoArea.removeFromBottom(valueLabelHeight);
     auto presetInfoDisplayArea = infoArea;
 
     peakValueLabel.setBounds(peakArea);
     lraValueLabel.setBounds(lraDisplayArea);
+    referenceValueLabel.setBounds(referenceArea);
     presetInfoLabel.setBounds(presetInfoDisplayArea);
+    doseValueLabel.setBounds(doseArea);
     
     // Position version label
-    versionLabel.setBounds(getLocalBounds().reduced(padding).removeFromBottom(15).removeFromRight(100));
+    auto footer = getLocalBounds().reduced(padding).removeFromBottom(15);
+    versionLabel.setBounds(footer.removeFromRight(100));
+    timingButton.setBounds(footer);
+}
+
+void DynamicsDoctorEditor::showTimingMenu()
+{
+    juce::PopupMenu menu;
+    menu.addItem("Save session report", [this]()
+    {
+        const auto file = processorRef.writeSessionReport();
+        if (file.existsAsFile())
+            file.revealToUser();
+    });
+    menu.addItem("Reset timing", [this]() { processorRef.resetTiming(); });
+
+    // Listening dose: standard and the monitor level a -20 LUFS programme plays at
+    const auto setParameter = [this](const juce::ParameterID& id, float value)
+    {
+        if (auto* parameter = valueTreeState.getParameter(id.getParamID()))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+
+    juce::PopupMenu doseMenu;
+    const int standardIndex = static_cast<int>(valueTreeState.getRawParameterValue(ParameterIDs::exposureStandard.getParamID())->load());
+    for (int i = 0; i < ExposureDose::numStandards; ++i)
+        doseMenu.addItem(ExposureDose::getStandard(i).label, true, i == standardIndex,
+                         [setParameter, i]() { setParameter(ParameterIDs::exposureStandard, static_cast<float>(i)); });
+
+    doseMenu.addSeparator();
+    const float calibration = valueTreeState.getRawParameterValue(ParameterIDs::monitorCalibration.getParamID())->load();
+    for (const float spl : { 73.0f, 76.0f, 79.0f, 82.0f, 85.0f })
+        doseMenu.addItem(juce::String(spl, 0) + " dB SPL at -20 LUFS", true, juce::approximatelyEqual(spl, calibration),
+                         [setParameter, spl]() { setParameter(ParameterIDs::monitorCalibration, spl); });
+
+    doseMenu.addSeparator();
+    doseMenu.addItem("Clear listening dose", [this]() { processorRef.clearExposure(); });
+    menu.addSubMenu("Listening dose", doseMenu);
+
+    menu.addItem("Save measurement with project", true, processorRef.isMeasurementSaved(),
+                 [this, setParameter]() { setParameter(ParameterIDs::saveMeasurement, processorRef.isMeasurementSaved() ? 0.0f : 1.0f); });
+    menu.addItem("Send meters to host", true, processorRef.isMeterOutputEnabled(),
+                 [this, setParameter]() { setParameter(ParameterIDs::meterOutput, processorRef.isMeterOutputEnabled() ? 0.0f : 1.0f); });
+    menu.addItem("Record timing", true, processorRef.isTimingEnabled(),
+                 [this]() { processorRef.setTimingEnabled(! processorRef.isTimingEnabled()); });
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&timingButton));
 }
 
 //==============================================================================
@@ -181,6 +278,10 @@ void DynamicsDoctorEditor::comboBoxChanged (juce::ComboBox* comboBoxThatHasChang
 {
     if (comboBoxThatHasChanged == &presetSelector)
     {
+        const int itemId = presetSelector.getSelectedId();
+        if (itemId > 0)
+            processorRef.selectPreset(itemId - 1);
+
         updateUIStatus();
     }
 }
@@ -190,50 +291,76 @@ void DynamicsDoctorEditor::comboBoxChanged (juce::ComboBox* comboBoxThatHasChang
 // In PluginEditor.cpp
 void DynamicsDoctorEditor::timerCallback()
 {
+    // Pick up user presets reloaded from disk
+    if (processorRef.getPresetRegistry().getTable().generation != presetTableGeneration)
+        refreshPresetList();
+    else if (presetSelector.getSelectedId() != processorRef.getSelectedPresetIndex() + 1)
+        presetSelector.setSelectedId(processorRef.getSelectedPresetIndex() + 1, juce::dontSendNotification); // Host automation or a loaded state
+
+    // One consistent view of the latest block for everything below; if the
+    // audio thread kept racing the read, the previous tick's view stays
+    processorRef.readAnalysisSnapshot(snapshot);
+
     // Update UI status
     updateUIStatus();
+
+    // Recent events, for "when did it go red and why"
+    auto& journal = processorRef.getEventJournal();
+    if (journal.getHistoryVersion() != eventHistoryVersion)
+    {
+        eventHistoryVersion = journal.getHistoryVersion();
+        const auto& history = journal.getHistory();
+        juce::StringArray lines;
+        const int numShown = juce::jmin(8, static_cast<int>(history.size()));
+        for (auto it = history.end() - numShown; it != history.end(); ++it)
+            lines.add(juce::Time(it->wallTimeMs).formatted("%H:%M:%S") + "  " + journal.describe(*it));
+        statusLabel.setTooltip(lines.joinIntoString("\n"));
+    }
+
+    // Let the analysis pool prioritise instances that someone is looking at
+    processorRef.setEditorShowing(isShowing());
+
+    timingButton.setButtonText(processorRef.isTimingEnabled() ? processorRef.getTimingSummary() : "DSP: timing off");
+    updateExposure();
+    updateReference();
     
     // Handle flashing states
-    auto* processor = dynamic_cast<DynamicsDoctorProcessor*>(getAudioProcessor());
-    if (processor != nullptr)
+    const bool isCurrentlyMeasuring = (snapshot.status == DynamicsStatus::Measuring);
+    const bool isAwaitingAudio = (snapshot.status == DynamicsStatus::AwaitingAudio);
+
+    if ((isCurrentlyMeasuring || isAwaitingAudio) && ! snapshot.isTransportPaused)
     {
-        const bool isCurrentlyMeasuring = (processor->getCurrentStatus() == DynamicsStatus::Measuring);
-        const bool isAwaitingAudio = (processor->getCurrentStatus() == DynamicsStatus::AwaitingAudio);
-        
-        if (isCurrentlyMeasuring || isAwaitingAudio)
+        // Handle measuring or awaiting audio state flashing
+        flashTimer += 1.0 / 30.0;
+        if (flashTimer >= FLASH_INTERVAL)
         {
-            // Handle measuring or awaiting audio state flashing
-            flashTimer += 1.0 / 30.0;
-            if (flashTimer >= FLASH_INTERVAL)
-            {
-                flashTimer = 0.0;
-                isFlashingStateOn = !isFlashingStateOn;
-                repaint();
-            }
-        }
-        else
-        {
-            isFlashingStateOn = false;
             flashTimer = 0.0;
+            isFlashingStateOn = !isFlashingStateOn;
+            repaint();
         }
     }
+    else
+    {
+        isFlashingStateOn = false;
+        flashTimer = 0.0;
+    }
 }
 
 //==============================================================================
 // Private Helper Function to Update UI Elements
 void DynamicsDoctorEditor::updateUIStatus()
 {
-    auto* processor = dynamic_cast<DynamicsDoctorProcessor*>(getAudioProcessor());
-    if (processor == nullptr) return;
-
-    const bool isBypassed = processor->isCurrentlyBypassed();
-    const bool isCurrentlyMeasuring = (processor->getCurrentStatus() == DynamicsStatus::Measuring);
-    const bool isAwaitingAudio = (processor->getCurrentStatus() == DynamicsStatus::AwaitingAudio);
+    const bool isBypassed = snapshot.isBypassed;
+    const bool isCurrentlyMeasuring = (snapshot.status == DynamicsStatus::Measuring);
+    const bool isAwaitingAudio = (snapshot.status == DynamicsStatus::AwaitingAudio);
 
     // Update status indicators
-    trafficLight.setStatus(processor->getCurrentStatus());
-    statusLabel.setText(getStatusMessage(processor->getCurrentStatus()), juce::dontSendNotification);
-    statusLabel.setColour(juce::Label::textColourId, getStatusColour(processor->getCurrentStatus()));
+    trafficLight.setStatus(snapshot.status);
+    trafficLight.setTentativeStatus(isCurrentlyMeasuring ? processorRef.getProvisionalStatus() : DynamicsStatus::Measuring);
+    const bool isPaused = snapshot.isTransportPaused && ! isBypassed;
+    statusLabel.setText(getStatusMessage(snapshot.status) + (isPaused ? " (paused)" : ""),
+                        juce::dontSendNotification);
+    statusLabel.setColour(juce::Label::textColourId, getStatusColour(snapshot.status));
 
     // Handle bypassed state
     if (isBypassed)
@@ -241,6 +368,7 @@ void DynamicsDoctorEditor::updateUIStatus()
         // Hide measurement displays
         peakValueLabel.setVisible(false);
         lraValueLabel.setVisible(false);
+        referenceValueLabel.setVisible(false);
         presetInfoLabel.setVisible(false);
 
         // Disable controls
@@ -254,15 +382,7 @@ void DynamicsDoctorEditor::updateUIStatus()
     else if (isAwaitingAudio)
     {
         // Update peak measurement
-        if (auto* peakParamPtr = valueTreeState.getRawParameterValue(ParameterIDs::peak.getParamID()))
-        {
-            peakValueLabel.setText("Peak: " + juce::String(peakParamPtr->load(), 1) + " dBFS", 
-                                 juce::dontSendNotification);
-        }
-        else
-        {
-            peakValueLabel.setText("Peak: --- dBFS", juce::dontSendNotification);
-        }
+        peakValueLabel.setText("Peak: " + juce::String(snapshot.peak, 1) + " dBFS", juce::dontSendNotification);
 
         // Update LRA display
         lraValueLabel.setText("Loudness Range (LRA): Waiting for audio...", juce::dontSendNotification);
@@ -289,18 +409,15 @@ void DynamicsDoctorEditor::updateUIStatus()
     else if (isCurrentlyMeasuring)
     {
         // Update peak measurement
-        if (auto* peakParamPtr = valueTreeState.getRawParameterValue(ParameterIDs::peak.getParamID()))
-        {
-            peakValueLabel.setText("Peak: " + juce::String(peakParamPtr->load(), 1) + " dBFS", 
-                                 juce::dontSendNotification);
-        }
-        else
-        {
-            peakValueLabel.setText("Peak: --- dBFS", juce::dontSendNotification);
-        }
+        peakValueLabel.setText("Peak: " + juce::String(snapshot.peak, 1) + " dBFS", juce::dontSendNotification);
 
-        // Update LRA display with measuring animation
-        lraValueLabel.setText("Loudness Range (LRA): Measuring...", juce::dontSendNotification);
+        // Update LRA display with measuring animation, or the provisional value once there is one
+        const auto estimate = processorRef.getProvisionalLRA();
+        if (estimate.isUsable())
+            lraValueLabel.setText("LRA: ~" + juce::String(estimate.lra, 1) + " +/- " + juce::String(estimate.halfWidth, 1) + " LU (provisional)",
+                                  juce::dontSendNotification);
+        else
+            lraValueLabel.setText("Loudness Range (LRA): Measuring...", juce::dontSendNotification);
         if (isFlashingStateOn)
         {
             lraValueLabel.setColour(juce::Label::textColourId, Palette::Reduced);
@@ -341,55 +458,148 @@ void DynamicsDoctorEditor::updateUIStatus()
 // Helper functions for updateUIStatus
 void DynamicsDoctorEditor::updateMeasurements()
 {
-    // Update peak measurement
-    if (auto* peakParamPtr = valueTreeState.getRawParameterValue(ParameterIDs::peak.getParamID()))
-    {
-        peakValueLabel.setText("Peak: " + juce::String(peakParamPtr->load(), 1) + " dBFS", 
-                             juce::dontSendNotification);
-    }
-    else
-    {
-        peakValueLabel.setText("Peak: --- dBFS", juce::dontSendNotification);
-    }
-    
-    // Update LRA measurement
-    if (auto* lraParamPtr = valueTreeState.getRawParameterValue(ParameterIDs::lra.getParamID()))
-    {
-        lraValueLabel.setText("LRA: " + juce::String(lraParamPtr->load(), 1) + " LU", 
-                            juce::dontSendNotification);
-    }
-    else
+    // Update peak measurement, with PSR and PLR once a full short-term window is in
+    const auto micro = processorRef.getMicroDynamics();
+    juce::String peakText = "Peak: " + juce::String(snapshot.peak, 1) + " dBFS";
+    if (micro.isAvailable)
+        peakText << "  PSR " << juce::String(micro.psr, 1) << "  PLR " << juce::String(micro.plr, 1);
+
+    peakValueLabel.setText(peakText, juce::dontSendNotification);
+    peakValueLabel.setTooltip(processorRef.describeMicroDynamics());
+    peakValueLabel.setColour(juce::Label::textColourId, processorRef.isOverLimited() ? Palette::Reduced
+                                                                                      : Palette::Foreground.withAlpha(0.7f));
+
+    // Update LRA measurement, naming the band that has lost the most dynamics
+    const auto bands = processorRef.getBandSummary();
+    const int leastDynamicBand = bands.getLeastDynamicBand();
+    juce::String lraText = "LRA: " + juce::String(snapshot.lra, 1) + " LU";
+    if (leastDynamicBand >= 0)
+        lraText << " (flattest: " << MultibandLoudness::getBandName(leastDynamicBand).upToFirstOccurrenceOf(" (", false, false) << ")";
+
+    lraValueLabel.setText(lraText, juce::dontSendNotification);
+    lraValueLabel.setTooltip(bands.isAvailable ? bands.describe(snapshot.lra) : juce::String());
+}
+
+void DynamicsDoctorEditor::refreshPresetList()
+{
+    auto& registry = processorRef.getPresetRegistry();
+    const auto& table = registry.getTable();
+    presetTableGeneration = table.generation;
+
+    // Presets removed from the file keep their slot; only the selected one is still shown
+    const int selectedIndex = processorRef.getSelectedPresetIndex();
+    presetSelector.clear(juce::dontSendNotification);
+    for (int i = 0; i < static_cast<int>(table.presets.size()); ++i)
     {
-        lraValueLabel.setText("Loudness Range (LRA): --- LU", juce::dontSendNotification);
+        if (table.isListed(i) || i == selectedIndex)
+            presetSelector.addItem (table.presets[static_cast<size_t>(i)].label, i + 1);
     }
+
+    // Show problems in the user preset file where the user will look for their presets
+    const auto loadReport = registry.getLastLoadReport();
+    presetSelector.setTooltip (loadReport.isEmpty()
+                                   ? juce::String ("Select the dynamic range reference standard")
+                                   : "Select the dynamic range reference standard\n\n" + loadReport);
+
+    presetSelector.setSelectedId(selectedIndex + 1, juce::dontSendNotification);
 }
 
 void DynamicsDoctorEditor::updatePresetInfo()
 {
+    const auto& table = processorRef.getPresetRegistry().getTable();
     int presetIndex = presetSelector.getSelectedId() - 1;
-    if (presetIndex >= 0 && static_cast<size_t>(presetIndex) < presets.size())
+    if (presetIndex >= 0 && static_cast<size_t>(presetIndex) < table.presets.size())
     {
-        const auto& selectedPreset = presets[presetIndex];
+        const auto& selectedPreset = table.presets[static_cast<size_t>(presetIndex)];
         juce::String infoText = selectedPreset.label + " (Target LRA: ";
         infoText += juce::String(selectedPreset.targetLraMin, 1) + " LU - ";
         infoText += juce::String(selectedPreset.targetLraMax, 1) + " LU)";
         presetInfoLabel.setText(infoText, juce::dontSendNotification);
+
+        // Every preset's verdict for the same measurement, to compare without switching
+        const auto verdicts = processorRef.getPresetVerdicts();
+        juce::StringArray verdictLines;
+        for (int i = 0; i < static_cast<int>(table.presets.size()); ++i)
+        {
+            if (! verdicts.hasVerdict(i) || ! table.isListed(i))
+                continue;
+
+            juce::String line = table.presets[static_cast<size_t>(i)].label + ": "
+                              + getStatusMessage(verdicts.getStatus(i)).fromFirstOccurrenceOf(": ", false, false);
+            if (verdicts.isBelowTarget(i))
+                line += " (below target)";
+            else if (verdicts.isAboveTarget(i))
+                line += " (above target)";
+            verdictLines.add(line);
+        }
+        presetInfoLabel.setTooltip(verdictLines.joinIntoString("\n"));
     }
     else
     {
         presetInfoLabel.setText("Select Preset", juce::dontSendNotification);
+        presetInfoLabel.setTooltip({});
     }
 }
 
+void DynamicsDoctorEditor::updateExposure()
+{
+    // Shown whatever the status: the day's dose doesn't stop when the meter does
+    const auto reading = processorRef.getExposureReading();
+    const auto& standard = processorRef.getExposureStandard();
+    doseValueLabel.setText("Dose: " + juce::String(reading.dosePercent, 0) + " % ("
+                               + juce::String(standard.label).upToFirstOccurrenceOf(" ", false, false) + ")",
+                           juce::dontSendNotification);
+
+    const float calibration = processorRef.getMonitorCalibration();
+    doseValueLabel.setTooltip(reading.describe(standard) + "\nCalibration: " + juce::String(calibration, 1)
+                              + " dB SPL at -20 LUFS (change it from the DSP menu)");
+
+    const auto colour = reading.dosePercent >= 100.0 ? Palette::Loss
+                      : reading.dosePercent >= 50.0  ? Palette::Reduced
+                                                     : Palette::Foreground.withAlpha(0.7f);
+    doseValueLabel.setColour(juce::Label::textColourId, colour);
+}
+
+void DynamicsDoctorEditor::updateReference()
+{
+    if (! processorRef.isReferenceConnected())
+    {
+        referenceValueLabel.setText("Reference: not connected", juce::dontSendNotification);
+        referenceValueLabel.setTooltip("Route the unprocessed mix to the sidechain input to see how much dynamics the chain removes");
+        referenceValueLabel.setColour(juce::Label::textColourId, Palette::DisabledText);
+        return;
+    }
+
+    // Deltas come with each LRA query, like the LRA itself
+    const auto comparison = processorRef.getReferenceComparison();
+    if (comparison.isAvailable)
+        referenceValueLabel.setText("Removed: LRA " + juce::String(comparison.getLraRemoved(), 1) + " LU, PLR "
+                                        + juce::String(comparison.getPlrRemoved(), 1) + " dB",
+                                    juce::dontSendNotification);
+    else
+        referenceValueLabel.setText("Reference: waiting for audio...", juce::dontSendNotification);
+
+    referenceValueLabel.setTooltip(comparison.describe());
+    referenceValueLabel.setColour(juce::Label::textColourId, Palette::Foreground.withAlpha(0.7f));
+}
+
 void DynamicsDoctorEditor::enableControls(bool enable)
 {
     peakValueLabel.setVisible(enable);
     lraValueLabel.setVisible(enable);
+    referenceValueLabel.setVisible(enable);
     presetInfoLabel.setVisible(enable);
     presetSelector.setEnabled(enable);
     presetLabel.setEnabled(enable);
+    rateSelector.setEnabled(enable);
     resetLraButton.setEnabled(enable);
     presetLabel.setColour(juce::Label::textColourId, 
                          enable ? Palette::Foreground : Palette::DisabledText);
 }
 
+void DynamicsDoctorEditor::setSessionOverviewVisible(bool shouldBeVisible)
+{
+    sessionViewport.setVisible(shouldBeVisible);
+    statusLabel.setVisible(! shouldBeVisible);
+    trafficLight.setVisible(! shouldBeVisible);
+}
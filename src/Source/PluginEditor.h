@@ -8,6 +8,7 @@
 // Include project-specific headers
 #include "PluginProcessor.h"
 #include "TrafficLightComponent.h" // Include the traffic light header
+#include "SessionOverviewComponent.h" // Session-wide instance list
 #include "Constants.h"             // For DynamicsStatus enum, ParameterIDs etc.
 
 //==============================================================================
@@ -66,7 +67,12 @@ private:
     //  HELPER METHOD DECLARATIONS
     void updateMeasurements();
     void updatePresetInfo();
+    void updateExposure();
+    void updateReference();
     void enableControls(bool enable);
+    void setSessionOverviewVisible(bool shouldBeVisible);
+    void showTimingMenu();
+    void refreshPresetList();
   
 
     // Reference to the processor object (required).
@@ -82,21 +88,37 @@ private:
     
 
     juce::Label presetLabel       { "presetLabel", "Preset:" };
+    juce::ComboBox rateSelector   { "rateSelector" };        // LRA evaluation rate
+    juce::Label rateLabel         { "rateLabel", "Update:" };
     juce::Label bypassLabel       { "bypassLabel", "Bypass" };
 
     juce::Label peakValueLabel    { "peakValueLabel", "-inf dBFS" }; // Default text
     juce::Label lraValueLabel    { "lraValueLabel", "0.0 LU" }; // Changed default text for clarity
     juce::Label presetInfoLabel   { "presetInfoLabel", ""};       // Initially empty
+    juce::Label doseValueLabel    { "doseValueLabel", "" };       // Listening dose, shown even when bypassed
+    juce::Label referenceValueLabel { "referenceValueLabel", "" }; // Dynamics removed against the reference input
     
     juce::TextButton resetLraButton { "Reset LRA" }; // Reset Button
+    juce::TextButton sessionButton  { "Session" };   // Toggles the session overview
+
+    SessionOverviewComponent sessionOverview;
+    juce::Viewport sessionViewport;
     
     juce::Label versionLabel      { "versionLabel", ""};
+    juce::TextButton timingButton { "DSP: no data" }; // Callback cost summary, click for options
     
     // --- Parameter Attachments ---
     // Use RAII to manage the connection between UI elements and parameters.
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> presetAttachment;
+    // The preset selector also lists user presets, which aren't parameter values,
+    // so it goes through DynamicsDoctorProcessor::selectPreset() instead.
+    juce::uint32 presetTableGeneration { 0 };  // Table the selector was last filled from
+    juce::uint32 eventHistoryVersion { 0 };    // Event history shown in the status tooltip
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> rateAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> resetLraButtonAttachment;
    
+    /** Latest block from the processor, read once per timer tick */
+    AnalysisSnapshot snapshot;
+
     /** UI animation state */
     bool isFlashingStateOn { false };
     double flashTimer { 0.0 };
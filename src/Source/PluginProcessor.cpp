@@ -2,6 +2,7 @@
 #include "PluginEditor.h"
 #include "Constants.h" // Include constants defining presets, IDs, etc.
 #include "LoudnessMeter.h"  // For our wrapper
+#include "PluginState.h"    // Binary state layout
 #include <cmath> // For std::log10, std::sqrt
 #include <algorithm> // For std::sort, std::max
 #include <limits>   // For std::numeric_limits
@@ -11,6 +12,7 @@ DynamicsDoctorProcessor::DynamicsDoctorProcessor()
      : AudioProcessor (BusesProperties()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Reference", juce::AudioChannelSet::stereo(), false)
                       ),
        parameters (*this, nullptr, juce::Identifier ("DynamicsDoctorParams"), createParameterLayout())
 {
@@ -18,34 +20,82 @@ DynamicsDoctorProcessor::DynamicsDoctorProcessor()
 
     // Initialize parameter pointers for real-time access
     presetParam = parameters.getRawParameterValue(ParameterIDs::preset.getParamID());
-    peakParam   = parameters.getRawParameterValue(ParameterIDs::peak.getParamID());
-    lraParam    = parameters.getRawParameterValue(ParameterIDs::lra.getParamID());
+    lraRateParam = parameters.getRawParameterValue(ParameterIDs::lraRate.getParamID());
+    decimationParam = parameters.getRawParameterValue(ParameterIDs::highRateDecimation.getParamID());
+    timelineParam = parameters.getRawParameterValue(ParameterIDs::timelineAligned.getParamID());
+    pauseWithTransportParam = parameters.getRawParameterValue(ParameterIDs::pauseWithTransport.getParamID());
+    bandAnalysisParam = parameters.getRawParameterValue(ParameterIDs::bandAnalysis.getParamID());
+    exposureStandardParam = parameters.getRawParameterValue(ParameterIDs::exposureStandard.getParamID());
+    monitorCalibrationParam = parameters.getRawParameterValue(ParameterIDs::monitorCalibration.getParamID());
+    saveMeasurementParam = parameters.getRawParameterValue(ParameterIDs::saveMeasurement.getParamID());
+    meterOutputParam = parameters.getRawParameterValue(ParameterIDs::meterOutput.getParamID());
+    peakParamObject = parameters.getParameter(ParameterIDs::peak.getParamID());
+    lraParamObject = parameters.getParameter(ParameterIDs::lra.getParamID());
     resetLraParamObject = dynamic_cast<juce::AudioParameterBool*>(parameters.getParameter(ParameterIDs::resetLra.getParamID()));
 
     // Validate parameter initialization
     jassert(presetParam != nullptr && "Preset parameter not found in parameter layout");
-    jassert(peakParam != nullptr && "Peak parameter not found in parameter layout");
-    jassert(lraParam != nullptr && "LRA parameter not found in parameter layout");
+    jassert(lraRateParam != nullptr && "LRA rate parameter not found in parameter layout");
+    jassert(decimationParam != nullptr && "Decimation parameter not found in parameter layout");
+    jassert(timelineParam != nullptr && "Timeline parameter not found in parameter layout");
+    jassert(pauseWithTransportParam != nullptr && "Pause with transport parameter not found in parameter layout");
+    jassert(bandAnalysisParam != nullptr && "Band analysis parameter not found in parameter layout");
+    jassert(exposureStandardParam != nullptr && "Exposure standard parameter not found in parameter layout");
+    jassert(monitorCalibrationParam != nullptr && "Monitor calibration parameter not found in parameter layout");
+    jassert(saveMeasurementParam != nullptr && "Save measurement parameter not found in parameter layout");
+    jassert(meterOutputParam != nullptr && "Meter output parameter not found in parameter layout");
+    jassert(peakParamObject != nullptr && lraParamObject != nullptr && "Meter parameters not found in parameter layout");
     jassert(resetLraParamObject != nullptr && "Reset LRA parameter not found or wrong type");
 
     // Register parameter listeners for state changes
     DBG("Constructor: Adding parameter listeners...");
     parameters.addParameterListener(ParameterIDs::resetLra.getParamID(), this);
     parameters.addParameterListener(ParameterIDs::preset.getParamID(), this);
+    parameters.addParameterListener(ParameterIDs::highRateDecimation.getParamID(), this);
+    parameters.addParameterListener(ParameterIDs::timelineAligned.getParamID(), this);
+    parameters.addParameterListener(ParameterIDs::bandAnalysis.getParamID(), this);
 
     // Verify preset default validity
-    jassert(ParameterDefaults::preset >= 0 && static_cast<size_t>(ParameterDefaults::preset) < presets.size() 
+    jassert(ParameterDefaults::preset >= 0 && static_cast<size_t>(ParameterDefaults::preset) < builtInPresets.size() 
             && "Default preset index is out of bounds");
 
+    // Join the session overview
+    sessionSlot = sessionRegistry->claimSlot();
+
+    // Checkpoint the measurement in the background from now on
+    checkpointWriter->registerClient(*this);
+
+    // Host meter output (does nothing until switched on)
+    startTimerHz(METER_OUTPUT_HZ);
+
     DBG("DynamicsDoctorProcessor Constructor - END");
 }
 
 DynamicsDoctorProcessor::~DynamicsDoctorProcessor()
 {
     DBG("DynamicsDoctorProcessor Destructor - START");
+    stopTimer();
+
+    // A render that ended just before we were closed still gets its report
+    if (renderFinishRequested.exchange(false))
+        finishOfflineRender();
+
     // Clean up parameter listeners
     parameters.removeParameterListener(ParameterIDs::resetLra.getParamID(), this);
     parameters.removeParameterListener(ParameterIDs::preset.getParamID(), this);
+    parameters.removeParameterListener(ParameterIDs::highRateDecimation.getParamID(), this);
+    parameters.removeParameterListener(ParameterIDs::timelineAligned.getParamID(), this);
+    parameters.removeParameterListener(ParameterIDs::bandAnalysis.getParamID(), this);
+
+    // Closed normally, so there is nothing to recover
+    checkpointWriter->unregisterClient(*this);
+    checkpoint.remove();
+
+    // Make sure no pool worker is still inside this instance
+    leaveAnalysisPool();
+
+    // Leave the session overview
+    sessionRegistry->releaseSlot(sessionSlot);
     DBG("DynamicsDoctorProcessor Destructor - END");
 }
 
@@ -54,20 +104,35 @@ juce::AudioProcessorValueTreeState::ParameterLayout DynamicsDoctorProcessor::cre
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
     
-    // Create preset parameter with labels from presets array
+    // Create preset parameter over the built-in presets, whose indices never change.
+    // User presets come and go with the preset file, so they are selected in the
+    // editor instead (see selectPreset). The text follows a built-in's replacement.
+    auto* registry = &presetRegistry.get();
     juce::StringArray presetLabels;
-    for (const auto& p : presets)
+    for (const auto& p : builtInPresets)
         presetLabels.add (p.label);
-    
+
+    auto presetAttributes = juce::AudioParameterChoiceAttributes()
+                                .withStringFromValueFunction ([registry](int index, int) { return registry->getLabel(index); })
+                                .withValueFromStringFunction ([registry](const juce::String& text)
+                                {
+                                    for (int i = 0; i < static_cast<int>(builtInPresets.size()); ++i)
+                                        if (registry->getLabel(i) == text)
+                                            return i;
+                                    return ParameterDefaults::preset;
+                                });
+
     params.push_back(std::make_unique<juce::AudioParameterChoice>(ParameterIDs::preset,
         "preset",
         presetLabels,
-        ParameterDefaults::preset));
+        ParameterDefaults::preset,
+        presetAttributes));
 
-    // Create peak level parameter with dBFS display
+    // Create peak level parameter with dBFS display. Peak and LRA are meters: the
+    // host sees them change only while meter output is on (see timerCallback)
     auto peakAttributes = juce::AudioParameterFloatAttributes()
                               .withStringFromValueFunction ([](float v, int) { return juce::String (v, 1) + " dBFS"; })
-                              .withAutomatable (false);
+                              .withCategory (juce::AudioProcessorParameter::analysisMeter);
     
     params.push_back (std::make_unique<juce::AudioParameterFloat>(
             ParameterIDs::peak,
@@ -79,7 +144,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout DynamicsDoctorProcessor::cre
     // Create LRA parameter with LU display
     auto lraAttributes = juce::AudioParameterFloatAttributes()
                          .withStringFromValueFunction ([](float v, int) { return juce::String (v, 1) + " LU"; })
-                         .withAutomatable (false);
+                         .withCategory (juce::AudioProcessorParameter::analysisMeter);
    
     params.push_back (std::make_unique<juce::AudioParameterFloat>(
             ParameterIDs::lra,
@@ -95,6 +160,80 @@ juce::AudioProcessorValueTreeState::ParameterLayout DynamicsDoctorProcessor::cre
             false,
             juce::AudioParameterBoolAttributes().withAutomatable(false)));
 
+    // Create LRA evaluation rate parameter (how often LRA and the status update)
+    juce::StringArray lraRateLabels;
+    for (const auto& r : lraRates)
+        lraRateLabels.add (r.label);
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(ParameterIDs::lraRate,
+        "LRA Update Rate",
+        lraRateLabels,
+        ParameterDefaults::lraRate));
+
+    // Create high-rate decimation switch (changing it restarts the measurement)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ParameterIDs::highRateDecimation,
+            "High-Rate Decimation",
+            ParameterDefaults::highRateDecimation,
+            juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
+    // Create timeline-aligned mode switch (changing it restarts the measurement)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ParameterIDs::timelineAligned,
+            "Timeline-Aligned LRA",
+            ParameterDefaults::timelineAligned,
+            juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
+    // Create transport pause switch (takes effect on the next block, no reset)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ParameterIDs::pauseWithTransport,
+            "Pause With Transport",
+            ParameterDefaults::pauseWithTransport,
+            juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
+    // Create band analysis switch (changing it restarts the measurement)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ParameterIDs::bandAnalysis,
+            "Band Analysis",
+            ParameterDefaults::bandAnalysis,
+            juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
+    // Create listening dose settings (read when a reading is taken, no reset)
+    juce::StringArray exposureLabels;
+    for (int i = 0; i < ExposureDose::numStandards; ++i)
+        exposureLabels.add (ExposureDose::getStandard(i).label);
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(ParameterIDs::exposureStandard,
+        "Exposure Standard",
+        exposureLabels,
+        ParameterDefaults::exposureStandard,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+    auto calibrationAttributes = juce::AudioParameterFloatAttributes()
+                                     .withStringFromValueFunction ([](float v, int) { return juce::String (v, 1) + " dB SPL"; })
+                                     .withAutomatable (false);
+
+    params.push_back (std::make_unique<juce::AudioParameterFloat>(
+            ParameterIDs::monitorCalibration,
+            "Monitor Calibration",
+            juce::NormalisableRange<float>(60.0f, 110.0f, 0.5f),
+            ParameterDefaults::monitorCalibration,
+            calibrationAttributes));
+
+    // Create measurement persistence switch (read when the host saves)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ParameterIDs::saveMeasurement,
+            "Save Measurement",
+            ParameterDefaults::saveMeasurement,
+            juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
+    // Create host meter output switch (takes effect on the next meter update)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+            ParameterIDs::meterOutput,
+            "Meter Output",
+            ParameterDefaults::meterOutput,
+            juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
     return { params.begin(), params.end() };
 }
 
@@ -102,33 +241,155 @@ juce::AudioProcessorValueTreeState::ParameterLayout DynamicsDoctorProcessor::cre
 void DynamicsDoctorProcessor::prepareToPlay (double newSampleRate, int samplesPerBlock)
 {
     DBG("--- PREPARE TO PLAY ---");
-    internalSampleRate = newSampleRate;
-    DBG("prepareToPlay - internalSampleRate: " << internalSampleRate
+    DBG("prepareToPlay - newSampleRate: " << newSampleRate
            << ", samplesPerBlock: " << samplesPerBlock);
 
+    // A render that has ended is reported before the meters are rebuilt
+    if (renderFinishRequested.exchange(false))
+        finishOfflineRender();
+
+    if (newSampleRate <= 0.0)
+    {
+        jassertfalse; // Hosts must give a real sample rate; nothing can be timed without one
+        return;
+    }
+
+    // Take ourselves out of the pool while the analysis side is rebuilt
+    leaveAnalysisPool();
+
+    // Every state-machine deadline is converted to whole samples once, here
+    internalSampleRate = newSampleRate;
+    audioClock.prepare(internalSampleRate);
+    blockStartSample.store(0);
+    transportHasPlayed = false;
+    eventJournal.setSampleRate(internalSampleRate);
+    deadlines.prepare(audioClock);
+
     // Initialize loudness meter
     int numChannelsForMeter = getTotalNumOutputChannels();
     if (numChannelsForMeter == 0) numChannelsForMeter = 2;
     
-    loudnessMeter.prepare(internalSampleRate, numChannelsForMeter, samplesPerBlock);
-    DBG("LoudnessMeter prepared in prepareToPlay.");
+    // The reference input is metered too when the host has connected it
+    const auto* referenceBus = getBus(true, 1);
+    const int numReferenceChannels = (referenceBus != nullptr && referenceBus->isEnabled()) ? referenceBus->getNumberOfChannels() : 0;
+
+    // The checkpoint writer and getStateInformation read the meters under
+    // analysisLock, so they are rebuilt under it too
+    {
+        const juce::SpinLock::ScopedLockType lock (analysisLock);
+
+        // The analysis side hands the meter up to one slice at a time
+        const int meterBlockSize = juce::jmax(samplesPerBlock, MAX_SAMPLES_PER_ANALYSIS_SLICE);
+        configureMeter();
+        loudnessMeter.prepare(internalSampleRate, numChannelsForMeter, meterBlockSize);
+        if (numReferenceChannels > 0)
+            referenceMeter.prepare(internalSampleRate, numReferenceChannels, meterBlockSize);
+        DBG("LoudnessMeter prepared in prepareToPlay" << (numReferenceChannels > 0 ? ", with a reference input." : "."));
+
+        // Size the analysis queue to hold a couple of seconds of audio (main channels, then reference channels)
+        const int queueSize = static_cast<int>(audioClock.toSamples(ANALYSIS_QUEUE_SECONDS)) + samplesPerBlock;
+        analysisBuffer.setSize(numChannelsForMeter + numReferenceChannels, queueSize, false, true);
+        analysisMainChannels = numChannelsForMeter;
+        analysisReferenceChannels = numReferenceChannels;
+        referenceConnected.store(numReferenceChannels > 0);
+        referenceComparison.publish({});
+        analysisFifo.setTotalSize(queueSize);
+        analysisFifo.reset();
+        timelineFifo.reset();
+        analysisSamplesQueued = 0;
+        analysisStreamPosition = 0;
+        expectedTimelineSample = UNKNOWN_TIMELINE;
+        timelineResyncRequested.store(true);
+        analysisResetPending.store(false);
+        analysisOverruns.store(0);
+
+        analysisSampleRate = internalSampleRate;
+        analysisBlockSize = meterBlockSize;
+        energyWindowLengthSamples = static_cast<int>(audioClock.toSamples(1.0));
+        economyLraPeriodSamples = internalSampleRate * ECONOMY_LRA_INTERVAL_SECONDS;
+        analysisTier = AnalysisTier::Full;
+        stableLraSeconds = 0.0;
+        energyWindowSum = 0.0;
+        energyWindowSamples = 0;
+        analysedLRA.store(0.0f);
+        lastSeenLraUpdate = lraUpdateCount.load();
+
+        analysisClock = 0;
+        restartLraSchedule(getStaggeredLraDelay());
+
+        // A measurement loaded with the state before we were prepared
+        restorePendingMeasurement();
+    }
+
+    // Callback cost is judged against the time one block of audio lasts
+    blockDeadlineMicros.store(samplesPerBlock * 1.0e6 / internalSampleRate);
+    resetTiming();
+
+    joinAnalysisPool();
     
     // Reset measurement state
     currentPeak.store(ParameterDefaults::peak);
     currentGlobalLRA.store(0.0f);
-    if (lraParam) lraParam->store(currentGlobalLRA.load());
 
     samplesProcessedSinceReset.store(0);
-    samplesUntilLraUpdate = 0;
-    currentStatus.store(DynamicsStatus::AwaitingAudio);  // Start in awaiting audio state
+    samplesSinceLastAudio.store(0);
+    setStatus(DynamicsStatus::AwaitingAudio);  // Start in awaiting audio state
     waitingForNextAudio.store(true);
     isInitialMeasuringPhase.store(true);
     
     DBG("prepareToPlay: currentStatus set to AwaitingAudio. Waiting for audio signal.");
+    publishAnalysisSnapshot();
+
+    // Prepared for another render without setNonRealtime being toggled in between
+    if (isNonRealtime() && ! offlineRenderActive.load())
+        beginOfflineRender();
 }
 
 void DynamicsDoctorProcessor::releaseResources()
 {
+    // Some hosts end a bounce here rather than with setNonRealtime(false)
+    requestOfflineRenderFinish();
+
+    // Nothing to analyse until the next prepareToPlay
+    leaveAnalysisPool();
+}
+
+void DynamicsDoctorProcessor::joinAnalysisPool()
+{
+    wantsAnalysisSlot.store(true);
+    analysisHandle.store(analysisPool->registerClient(*this));
+    if (analysisHandle.load() < 0)
+        DBG("joinAnalysisPool: Analysis pool is full; audio is dropped until a slot frees up.");
+}
+
+void DynamicsDoctorProcessor::leaveAnalysisPool()
+{
+    wantsAnalysisSlot.store(false);
+    analysisPool->unregisterClient(analysisHandle.exchange(-1));
+}
+
+void DynamicsDoctorProcessor::setNonRealtime (bool shouldBeNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(shouldBeNonRealtime);
+
+    // May be called on the audio thread and must not throw, so the end of a
+    // render is only flagged here; the timer drains and reports it
+    if (shouldBeNonRealtime)
+    {
+        renderFinishRequested.store(false); // Back to offline before the report: one render
+        if (! offlineRenderActive.load())
+            beginOfflineRender();
+    }
+    else
+    {
+        requestOfflineRenderFinish();
+    }
+}
+
+void DynamicsDoctorProcessor::requestOfflineRenderFinish() noexcept
+{
+    if (offlineRenderActive.load())
+        renderFinishRequested.store(true);
 }
 
 bool DynamicsDoctorProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -149,14 +410,28 @@ bool DynamicsDoctorProcessor::isBusesLayoutSupported (const BusesLayout& layouts
         return false;
     #endif
 
+    // The reference (sidechain) input is optional, mono or stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto referenceSet = layouts.getChannelSet(true, 1);
+        if (! referenceSet.isDisabled() && referenceSet != juce::AudioChannelSet::mono()
+                                        && referenceSet != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
     return true;
 }
 
 //==============================================================================
 void DynamicsDoctorProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const ScopedTimingSample callbackTimer (callbackTiming, timingEnabled);
     juce::ScopedNoDenormals noDenormals;
     juce::ignoreUnused(midiMessages);
+
+    const int numSamples = buffer.getNumSamples();
+    blockStartSample.store(audioClock.getNow());
+    audioClock.advance(numSamples);
     
     // Get channel counts and clear excess channels
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -165,19 +440,17 @@ void DynamicsDoctorProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
+    // Single magnitude pass shared by the activity check and the peak meter (the
+    // reference input, if any, follows the main channels and is only analysed)
+    float blockMax = 0.0f;
+    for (int ch = 0; ch < getMainBusNumInputChannels(); ++ch) {
+        blockMax = std::max(blockMax, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
+    }
+
     // Check for audio activity in the block with a more reasonable threshold
-    bool isAudioPresentInBlock = false;
     const float AUDIO_THRESHOLD = -60.0f; // -60 dBFS threshold
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
-    {
-        float magnitude = buffer.getMagnitude(ch, 0, buffer.getNumSamples());
-        float dbMagnitude = juce::Decibels::gainToDecibels(magnitude, -std::numeric_limits<float>::infinity());
-        if (dbMagnitude > AUDIO_THRESHOLD)
-        {
-            isAudioPresentInBlock = true;
-            break;
-        }
-    }
+    const bool isAudioPresentInBlock =
+        juce::Decibels::gainToDecibels(blockMax, -std::numeric_limits<float>::infinity()) > AUDIO_THRESHOLD;
     
     // Handle bypass state
     const bool bypassed = (bypassParam != nullptr) ? (bypassParam->load() > 0.5f) : false;
@@ -185,46 +458,96 @@ void DynamicsDoctorProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     {
         if (currentStatus.load() != DynamicsStatus::Bypassed)
         {
-            currentStatus.store(DynamicsStatus::Bypassed);
+            setStatus(DynamicsStatus::Bypassed);
+            eventJournal.record(EventJournal::Type::Bypass, blockStartSample.load(), currentGlobalLRA.load(), 0, 1);
             DBG("PROCESSOR::processBlock - Entered Bypassed state.");
         }
+        publishBlockResults();
         return;
     }
     
     // Handle transition from bypassed state
     if (currentStatus.load() == DynamicsStatus::Bypassed)
     {
-        currentStatus.store(DynamicsStatus::AwaitingAudio);
+        eventJournal.record(EventJournal::Type::Bypass, blockStartSample.load(), currentGlobalLRA.load(), 1, 0);
+        setStatus(DynamicsStatus::AwaitingAudio);
         waitingForNextAudio.store(true);
         isInitialMeasuringPhase.store(true);
-        timeSinceLastAudio.store(0.0);  // Reset the timeout counter
+        samplesSinceLastAudio.store(0);  // Reset the timeout counter
         DBG("PROCESSOR::processBlock - Transitioning FROM Bypassed state. Entering AwaitingAudio state.");
     }
     
     // Track peak level
-    float blockMax = 0.0f;
-    for (int ch = 0; ch < totalNumInputChannels; ++ch) {
-        blockMax = std::max(blockMax, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
-    }
     currentPeak.store(juce::Decibels::gainToDecibels(blockMax, -std::numeric_limits<float>::infinity()));
-    if (peakParam != nullptr) peakParam->store(currentPeak);
-    
-    // Process audio through loudness meter
-    loudnessMeter.processBlock(buffer);
+
+    // Hold the highest peak until the next host meter update takes it
+    const float blockPeak = currentPeak.load();
+    auto heldPeak = meterPeakHold.load();
+    while (blockPeak > heldPeak && ! meterPeakHold.compare_exchange_weak(heldPeak, blockPeak))
+    {
+    }
+
+    if (offlineRenderActive.load())
+    {
+        renderSamples.store(renderSamples.load() + numSamples);
+        renderPeakGain.store(juce::jmax(renderPeakGain.load(), blockMax));
+    }
+
+    // Host transport, if the host reports one
+    juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+    if (auto* playHead = getPlayHead())
+        position = playHead->getPosition();
+
+    // Transport stopped: freeze the measurement exactly where it is. Nothing is
+    // analysed and no state or timeout moves on, so pressing play carries on
+    // with the same history, the same measuring progress and the same status.
+    // Only once the transport has played: hosts that never start it (live
+    // input, a stopped session used for monitoring) are measured as usual.
+    if (position.hasValue() && position->getIsPlaying())
+        transportHasPlayed = true;
+    const bool pauseForTransport = transportHasPlayed && position.hasValue() && ! position->getIsPlaying()
+                                   && pauseWithTransportParam != nullptr && pauseWithTransportParam->load() > 0.5f;
+    if (pauseForTransport != transportPaused.load())
+    {
+        transportPaused.store(pauseForTransport);
+        eventJournal.record(EventJournal::Type::Transport, blockStartSample.load(), currentGlobalLRA.load(),
+                            pauseForTransport ? 0 : 1, pauseForTransport ? 1 : 0);
+        DBG("processBlock: Transport " << (pauseForTransport ? "stopped, measurement paused" : "playing, measurement resumed"));
+    }
+    if (pauseForTransport)
+    {
+        expectedTimelineSample = UNKNOWN_TIMELINE; // The playhead may be moved while stopped
+        applyPublishedLRA(); // e.g. the final evaluation of a render that just finished
+        publishBlockResults();
+        return;
+    }
     
-    // Calculate time increment based on block size and sample rate
-    double blockDuration = buffer.getNumSamples() / (internalSampleRate > 0.0 ? internalSampleRate : 44100.0);
+    // Hand the block to the analysis side (shared worker pool). In timeline-aligned
+    // mode only audio played from the timeline counts, keyed to its position.
+    if (! isTimelineAligned())
+    {
+        pushToAnalysis(buffer, UNKNOWN_TIMELINE);
+    }
+    else
+    {
+        if (! position.hasValue())
+            pushToAnalysis(buffer, -1); // No timeline from this host: measure as usual
+        else if (position->getIsPlaying())
+            pushToAnalysis(buffer, position->getTimeInSamples().orFallback(-1));
+        else
+            expectedTimelineSample = UNKNOWN_TIMELINE; // Stopped: nothing to key, resync on play
+    }
     
     // Handle state transitions based on audio presence
     if (isAudioPresentInBlock)
     {
         // Reset timeout counter since we have audio
-        timeSinceLastAudio.store(0.0);
+        samplesSinceLastAudio.store(0);
         
         // If we were in AwaitingAudio state, transition to Measuring
         if (currentStatus.load() == DynamicsStatus::AwaitingAudio)
         {
-            currentStatus.store(DynamicsStatus::Measuring);
+            setStatus(DynamicsStatus::Measuring);
             samplesProcessedSinceReset.store(0);
             waitingForNextAudio.store(false);
             DBG("processBlock: Audio detected, entering Measuring state");
@@ -233,7 +556,7 @@ void DynamicsDoctorProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         // Update measurement duration counter if in Measuring state
         if (currentStatus.load() == DynamicsStatus::Measuring)
         {
-            samplesProcessedSinceReset.fetch_add(buffer.getNumSamples());
+            samplesProcessedSinceReset.fetch_add(numSamples);
         }
     }
     else
@@ -241,7 +564,7 @@ void DynamicsDoctorProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         // If we're in Measuring state and audio stops, return to AwaitingAudio
         if (currentStatus.load() == DynamicsStatus::Measuring)
         {
-            currentStatus.store(DynamicsStatus::AwaitingAudio);
+            setStatus(DynamicsStatus::AwaitingAudio);
             waitingForNextAudio.store(true);
             DBG("processBlock: Audio stopped during measuring, returning to AwaitingAudio state");
         }
@@ -249,188 +572,1032 @@ void DynamicsDoctorProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
         else if (currentStatus.load() != DynamicsStatus::AwaitingAudio && 
                  currentStatus.load() != DynamicsStatus::Bypassed)
         {
-            double currentTimeout = timeSinceLastAudio.load();
-            timeSinceLastAudio.store(currentTimeout + blockDuration);
+            const auto silentSamples = samplesSinceLastAudio.load() + numSamples;
+            samplesSinceLastAudio.store(silentSamples);
             
             // Only transition to AwaitingAudio after 5 minutes of no audio
-            if (currentTimeout + blockDuration >= AUDIO_TIMEOUT)
+            if (silentSamples >= deadlines.audioTimeout)
             {
                 waitingForNextAudio.store(true);
-                currentStatus.store(DynamicsStatus::AwaitingAudio);
+                setStatus(DynamicsStatus::AwaitingAudio);
                 DBG("processBlock: No audio for 5 minutes, entering AwaitingAudio state");
             }
         }
     }
     
-    // Handle periodic LRA updates
-    samplesUntilLraUpdate -= buffer.getNumSamples();
-    if (samplesUntilLraUpdate <= 0)
+    // Take up LRA updates published by the analysis side
+    applyPublishedLRA();
+
+    // Publish to the editor and the session overview (constant cost per instance)
+    publishBlockResults();
+}
+
+//==============================================================================
+AnalysisSnapshot DynamicsDoctorProcessor::makeAnalysisSnapshot() const
+{
+    AnalysisSnapshot snapshot;
+    snapshot.peak = currentPeak.load();
+    snapshot.lra = currentGlobalLRA.load();
+    snapshot.status = currentStatus.load();
+    snapshot.isBypassed = isCurrentlyBypassed();
+    snapshot.isTransportPaused = transportPaused.load();
+    return snapshot;
+}
+
+void DynamicsDoctorProcessor::publishBlockResults()
+{
+    const auto snapshot = makeAnalysisSnapshot();
+    analysisSnapshot.tryPublish(snapshot);
+    sessionRegistry->publish(sessionSlot, snapshot.lra, snapshot.peak, snapshot.status);
+}
+
+void DynamicsDoctorProcessor::publishAnalysisSnapshot()
+{
+    analysisSnapshot.tryPublish(makeAnalysisSnapshot());
+}
+
+void DynamicsDoctorProcessor::timerCallback()
+{
+    // The host has ended a render: drain, evaluate and report it here, off the audio thread
+    if (renderFinishRequested.exchange(false))
+        finishOfflineRender();
+
+    // Prepared while the pool was full: take the next slot that frees up
+    if (wantsAnalysisSlot.load() && analysisHandle.load() < 0)
+        analysisHandle.store(analysisPool->registerClient(*this));
+
+    // Taken even while switched off, so switching on doesn't send a stale peak
+    const float heldPeak = meterPeakHold.exchange(ParameterDefaults::peak);
+    if (! isMeterOutputEnabled())
+        return;
+
+    AnalysisSnapshot snapshot;
+    if (! readAnalysisSnapshot(snapshot) || snapshot.frame == 0)
+        return;
+
+    // Quantised, and sent only when the quantised value moves, so a steady meter costs the host nothing
+    const auto send = [](juce::RangedAudioParameter& parameter, float value, float step, float& lastSent)
     {
-        double rate = (internalSampleRate > 0.0) ? internalSampleRate : 44100.0;
-        samplesUntilLraUpdate += static_cast<int>(rate);
-        
-        // Get current LRA from meter
-        float newLRA = loudnessMeter.getLoudnessRange();
-        if (std::isinf(newLRA) || std::isnan(newLRA) || newLRA < 0)
-        {
-            newLRA = 0.0f;
-        }
-        
-        // Update LRA values
-        currentGlobalLRA.store(newLRA);
-        if (lraParam != nullptr)
-        {
-            lraParam->store(newLRA);
-        }
-        
-        // Handle state transitions based on measurement phase
-        if (currentStatus.load() == DynamicsStatus::Measuring)
-        {
-            const int minSamplesForReliableLRA = static_cast<int>(rate * LRA_MEASURING_DURATION_SECONDS);
-            
-            if (samplesProcessedSinceReset.load() >= minSamplesForReliableLRA)
-            {
-                isInitialMeasuringPhase.store(false);
-                updateStatusBasedOnLRA(newLRA);
-                DBG("processBlock: Measurement complete, transitioning to active state");
-            }
-        }
-        else if (currentStatus.load() != DynamicsStatus::AwaitingAudio && 
-                 currentStatus.load() != DynamicsStatus::Bypassed)
-        {
-            // In active state, update status based on LRA
-            updateStatusBasedOnLRA(newLRA);
-        }
-    }
+        const float quantised = parameter.getNormalisableRange().snapToLegalValue(step * std::round(value / step));
+        if (juce::approximatelyEqual(quantised, lastSent))
+            return;
+
+        lastSent = quantised;
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(quantised));
+    };
+
+    send(*peakParamObject, heldPeak, METER_PEAK_STEP_DB, lastSentPeak);
+    send(*lraParamObject, snapshot.lra, METER_LRA_STEP_LU, lastSentLRA);
 }
 
 //==============================================================================
-void DynamicsDoctorProcessor::updateStatusBasedOnLRA(float measuredLRA)
+void DynamicsDoctorProcessor::applyPublishedLRA()
 {
-    if (presetParam == nullptr) {
-        currentStatus.store(DynamicsStatus::Ok);
+    // Updates that raced with a pending reset belong to the old measurement.
+    const auto lraUpdate = lraUpdateCount.load();
+    if (lraUpdate == lastSeenLraUpdate || analysisResetPending.load())
         return;
+
+    lastSeenLraUpdate = lraUpdate;
+    
+    // Get current LRA from meter
+    float newLRA = analysedLRA.load();
+    if (std::isinf(newLRA) || std::isnan(newLRA) || newLRA < 0)
+    {
+        newLRA = 0.0f;
     }
     
-    // Get current preset and validate index
-    const int presetIndex = static_cast<int>(presetParam->load());
-    const int validPresetIndex = (presetIndex >= 0 && static_cast<size_t>(presetIndex) < presets.size())
-                                 ? presetIndex
-                                 : ParameterDefaults::preset;
-    const auto& selectedPreset = presets[validPresetIndex];
+    // Update LRA values
+    currentGlobalLRA.store(newLRA);
+    
+    // A measurement restored with the plugin state was finished when it was saved
+    if (measurementRestored.exchange(false))
+    {
+        samplesProcessedSinceReset.store(deadlines.measuringDuration);
+        samplesSinceLastAudio.store(0);
+        waitingForNextAudio.store(false);
+        isInitialMeasuringPhase.store(false);
+        statusFilter.reset();
+        updateStatusBasedOnLRA(newLRA);
+        DBG("processBlock: Restored measurement, status taken from its LRA");
+        return;
+    }
 
-    // Determine status based on LRA thresholds
-    DynamicsStatus newStatus;
-    if (measuredLRA < selectedPreset.lraThresholdRed) {
-        newStatus = DynamicsStatus::Loss;
-    } else if (measuredLRA < selectedPreset.lraThresholdAmber) {
-        newStatus = DynamicsStatus::Reduced;
-    } else {
-        newStatus = DynamicsStatus::Ok;
+    // Handle state transitions based on measurement phase
+    if (currentStatus.load() == DynamicsStatus::Measuring)
+    {
+        if (samplesProcessedSinceReset.load() >= deadlines.measuringDuration)
+        {
+            isInitialMeasuringPhase.store(false);
+            statusFilter.reset(); // A new measurement starts from a clean slate
+            updateStatusBasedOnLRA(newLRA);
+            DBG("processBlock: Measurement complete, transitioning to active state");
+        }
+    }
+    else if (currentStatus.load() != DynamicsStatus::AwaitingAudio && 
+             currentStatus.load() != DynamicsStatus::Bypassed)
+    {
+        // In active state, update status based on LRA
+        updateStatusBasedOnLRA(newLRA);
     }
-    currentStatus.store(newStatus);
 }
 
-//==============================================================================
-void DynamicsDoctorProcessor::handleResetLRA()
+void DynamicsDoctorProcessor::pushToAnalysis(const juce::AudioBuffer<float>& buffer, juce::int64 timelineSample)
 {
-    DBG("    **********************************************************");
-    DBG("    PROCESSOR: handleResetLRA() - Entered.");
+    const int numSamples = buffer.getNumSamples();
+    const int handle = analysisHandle.load();
 
-    // Validate sample rate
-    if (internalSampleRate <= 0.0) {
-        DBG("    PROCESSOR: handleResetLRA() - ABORTING: Invalid sample rate: " << internalSampleRate);
-        DBG("    **********************************************************");
-        return;
+    // A timeline jump (or a reset on the analysis side) needs a marker at this block
+    const bool needsMarker = (timelineSample != UNKNOWN_TIMELINE)
+                             && (timelineSample != expectedTimelineSample || timelineResyncRequested.load());
+
+    const auto hasRoom = [&]
+    {
+        return analysisFifo.getFreeSpace() >= numSamples && (! needsMarker || timelineFifo.getFreeSpace() >= 1);
+    };
+
+    // A render has no deadline but must not lose audio. The render thread is not
+    // a real-time thread, so it may wait for the pool; the analysis stays on the workers.
+    // Once the host is back in real time, even a render not yet reported never waits.
+    if (offlineRenderActive.load() && isNonRealtime())
+    {
+        while (! hasRoom() && handle >= 0 && analysisHandle.load() == handle)
+        {
+            analysisPool->notifyWorkAvailable(handle);
+            juce::Thread::sleep(1);
+        }
     }
 
-    // Prepare loudness meter with current settings
-    int numChannelsForMeter = getTotalNumOutputChannels();
-    if (numChannelsForMeter == 0) {
-        numChannelsForMeter = 2;
-        DBG("    PROCESSOR: handleResetLRA() - Using default channel count: 2");
+    // Nothing is ever analysed on the audio thread: with the queue full (or no
+    // pool slot yet) the block is dropped and counted, and the worker catches up
+    if (! hasRoom())
+    {
+        analysisOverruns.fetch_add(1);
+        expectedTimelineSample = UNKNOWN_TIMELINE; // The dropped block breaks continuity
+        return;
     }
 
-    int blockSizeToUse = getBlockSize();
-    if (blockSizeToUse == 0) {
-        blockSizeToUse = 512;
-        DBG("    PROCESSOR: handleResetLRA() - Using default block size: 512");
+    if (needsMarker)
+    {
+        timelineResyncRequested.store(false);
+        int markerStart1, markerSize1, markerStart2, markerSize2;
+        timelineFifo.prepareToWrite(1, markerStart1, markerSize1, markerStart2, markerSize2);
+        timelineMarkers[static_cast<size_t>(markerSize1 > 0 ? markerStart1 : markerStart2)] = { analysisSamplesQueued, timelineSample };
+        timelineFifo.finishedWrite(1);
     }
+    expectedTimelineSample = (timelineSample >= 0) ? timelineSample + numSamples : timelineSample;
+    analysisSamplesQueued += numSamples;
 
-    // Reset meter and measurement state
-    loudnessMeter.prepare(internalSampleRate, numChannelsForMeter, blockSizeToUse);
-    currentGlobalLRA.store(0.0f);
-    if (lraParam) {
-        lraParam->store(currentGlobalLRA.load());
+    int start1, size1, start2, size2;
+    analysisFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    const int numChannels = juce::jmin(buffer.getNumChannels(), analysisBuffer.getNumChannels());
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (size1 > 0) analysisBuffer.copyFrom(ch, start1, buffer, ch, 0, size1);
+        if (size2 > 0) analysisBuffer.copyFrom(ch, start2, buffer, ch, size1, size2);
     }
 
-    samplesProcessedSinceReset.store(0);
-    samplesUntilLraUpdate = 0;
-    currentStatus.store(DynamicsStatus::AwaitingAudio);  // Set to awaiting audio state
-    
-    // Reset audio state monitoring
-    timeSinceLastAudio.store(0.0);
-    waitingForNextAudio.store(true);
-    isInitialMeasuringPhase.store(true);
+    analysisFifo.finishedWrite(size1 + size2);
 
-    DBG("handleResetLRA: currentStatus set to AwaitingAudio. Waiting for audio signal.");
-    DBG("    PROCESSOR: handleResetLRA() - Reset complete.");
-    DBG("    **********************************************************");
+    // Past the high-water mark: ask our worker not to sleep through its next poll
+    if (handle >= 0 && analysisFifo.getNumReady() > analysisFifo.getTotalSize() / 2)
+        analysisPool->notifyWorkAvailable(handle);
 }
 
 //==============================================================================
-void DynamicsDoctorProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+bool DynamicsDoctorProcessor::runAnalysisSlice()
 {
-    DBG("--------------------------------------------------------------");
-    DBG("PROCESSOR: parameterChanged - Parameter: '" << parameterID
-        << "', Value: " << newValue << (newValue > 0.5f ? " (TRUE)" : " (FALSE)"));
+    const juce::SpinLock::ScopedTryLockType lock (analysisLock);
+    if (! lock.isLocked())
+        return false; // Another thread is already analysing this instance
 
-    // Handle reset button
-    if (parameterID == ParameterIDs::resetLra.getParamID())
+    if (analysisResetPending.load())
     {
-        if (newValue > 0.5f)
+        // Restart the meter and drop audio queued before the reset
+        configureMeter();
+        loudnessMeter.prepare(analysisSampleRate, analysisMainChannels, analysisBlockSize);
+        if (analysisReferenceChannels > 0)
+            referenceMeter.prepare(analysisSampleRate, analysisReferenceChannels, analysisBlockSize);
+        referenceComparison.publish({});
+        const int numDropped = analysisFifo.getNumReady();
+        analysisFifo.finishedRead(numDropped);
+        analysisStreamPosition += numDropped;
+        timelineResyncRequested.store(true); // The meter no longer knows where it is
+        setAnalysisTier(AnalysisTier::Full);
+        analysisClock = 0;
+        restartLraSchedule(getStaggeredLraDelay());
+        lraEvaluationPending.store(false);
+        restorePendingMeasurement();
+        analysisResetPending.store(false);
+    }
+
+    // Someone opened the editor: go back to full rate straight away
+    if (analysisTier == AnalysisTier::Economy && editorShowing.load())
+        setAnalysisTier(AnalysisTier::Full);
+
+    // The rate may have changed since the current series started; keep the
+    // pending deadline unless the new period would bring it forward
+    if (getLraPeriodSamples() != lraSchedule.getPeriodSamples())
+        restartLraSchedule(juce::jmin(lraSchedule.getNextDeadline(),
+                                      analysisClock + static_cast<juce::int64>(getLraPeriodSamples())));
+
+    // Renders are drained in larger batches: fewer hand-offs, same result
+    const int sliceSize = offlineRenderActive.load() ? MAX_SAMPLES_PER_ANALYSIS_SLICE * OFFLINE_SLICE_FACTOR
+                                                     : MAX_SAMPLES_PER_ANALYSIS_SLICE;
+    const int numToRead = juce::jmin(analysisFifo.getNumReady(), sliceSize);
+
+    int start1, size1, start2, size2;
+    analysisFifo.prepareToRead(numToRead, start1, size1, start2, size2);
+    analyseQueuedRange(start1, size1);
+    analyseQueuedRange(start2, size2);
+    analysisFifo.finishedRead(size1 + size2);
+
+    // A bounded step of the LRA evaluation per slice keeps every slice short
+    continueLraEvaluation(LRA_BINS_PER_SLICE);
+
+    // The running estimate is O(1) to read, so it goes out with every slice
+    const auto estimate = loudnessMeter.getProvisionalLoudnessRange();
+    provisionalLRA.store(estimate.lra);
+    provisionalHalfWidth.store(estimate.halfWidth);
+    provisionalValueCount.store(estimate.numValues);
+
+    // Whole seconds of programme for the listening dose; a bounce isn't listened to
+    double exposureEnergy = 0.0;
+    int exposureSeconds = 0;
+    loudnessMeter.takeExposure(exposureEnergy, exposureSeconds);
+    if (! offlineRenderActive.load())
+        exposureDose.addSeconds(exposureEnergy, exposureSeconds);
+
+    return analysisFifo.getNumReady() > 0;
+}
+
+void DynamicsDoctorProcessor::analyseQueuedRange(int startSample, int numSamples)
+{
+    // An offline render evaluates LRA once, when it finishes
+    const bool deferLra = offlineRenderActive.load();
+
+    while (numSamples > 0)
+    {
+        // Split at the next LRA query so it happens on the exact sample
+        // (a deadline that is already due is served before any more audio)
+        const auto samplesToDeadline = deferLra ? static_cast<juce::int64>(numSamples)
+                                                : lraSchedule.getNextDeadline() - analysisClock;
+        int chunk = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, samplesToDeadline));
+
+        // ...and at the next timeline marker, so the meter learns about a jump on its first sample
+        const auto samplesToMarker = applyTimelineMarkers();
+        chunk = static_cast<int>(juce::jmin<juce::int64>(chunk, samplesToMarker));
+
+        if (chunk > 0)
         {
-            DBG("PROCESSOR: Reset triggered. Calling handleResetLRA()");
-            handleResetLRA();
-            
-            // Reset button state
-            if (resetLraParamObject != nullptr)
+            juce::AudioBuffer<float> view (analysisBuffer.getArrayOfWritePointers(),
+                                           analysisMainChannels, startSample, chunk);
+            if (analysisTier == AnalysisTier::Economy)
             {
-                resetLraParamObject->beginChangeGesture();
-                resetLraParamObject->setValueNotifyingHost(0.0f);
-                resetLraParamObject->endChangeGesture();
+                // Energy only: the meter bridges the chunk on the level it implies
+                const ScopedTimingSample meterTimer (meterTiming, timingEnabled);
+                loudnessMeter.bridgeUnfiltered(chunk, lastEnergyLevelDb + economyLoudnessOffsetDb);
+                trackEconomyEnergy(view);
             }
             else
             {
-                auto* paramToReset = static_cast<juce::AudioParameterBool*>(
-                    parameters.getParameter(ParameterIDs::resetLra.getParamID()));
-                if (paramToReset != nullptr) {
-                    paramToReset->beginChangeGesture();
-                    paramToReset->setValueNotifyingHost(0.0f);
-                    paramToReset->endChangeGesture();
-                } else {
-                    DBG("PROCESSOR: ERROR - Reset parameter not found!");
-                    jassertfalse;
+                {
+                    const ScopedTimingSample meterTimer (meterTiming, timingEnabled);
+                    loudnessMeter.processBlock(view);
+
+                    // Same chunk of the reference input, so both meters hop on the same samples
+                    if (analysisReferenceChannels > 0)
+                    {
+                        juce::AudioBuffer<float> referenceView (analysisBuffer.getArrayOfWritePointers() + analysisMainChannels,
+                                                                analysisReferenceChannels, startSample, chunk);
+                        referenceMeter.processBlock(referenceView);
+                    }
                 }
+
+                // Silence skipped by the meter can't change the verdict, so it doesn't count here either
+                if (! loudnessMeter.isSkippingSilence())
+                    trackEconomyEnergy(view);
             }
+
+            startSample += chunk;
+            numSamples -= chunk;
+            analysisClock += chunk;
+            analysisStreamPosition += chunk;
+        }
+
+        if (! deferLra && analysisClock >= lraSchedule.getNextDeadline())
+        {
+            // At very high rates the previous evaluation may still be running; finish it first
+            if (lraEvaluationPending.load())
+                continueLraEvaluation(LoudnessRangeHistogram::numBins * 2);
+
+            // Snapshot the histogram at this exact sample; the work is spread over the next slices
+            loudnessMeter.beginLoudnessRange();
+            if (analysisReferenceChannels > 0)
+                referenceMeter.beginLoudnessRange();
+            lraEvaluationPending.store(true);
+
+            // Deadlines come from the series origin, so the cadence never drifts with the block size
+            lraSchedule.advance();
+            if (lraSchedule.getNextDeadline() <= analysisClock)
+                restartLraSchedule(analysisClock + static_cast<juce::int64>(getLraPeriodSamples())); // Never catch up in a burst
         }
     }
-    // Handle preset changes
-    else if (parameterID == ParameterIDs::preset.getParamID())
+}
+
+juce::int64 DynamicsDoctorProcessor::applyTimelineMarkers()
+{
+    while (timelineFifo.getNumReady() > 0)
     {
-        DBG("PROCESSOR: Preset changed. Resetting measurement.");
-        handleResetLRA();
+        int start1, size1, start2, size2;
+        timelineFifo.prepareToRead(1, start1, size1, start2, size2);
+        const auto& marker = timelineMarkers[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+
+        if (marker.streamPosition > analysisStreamPosition)
+            return marker.streamPosition - analysisStreamPosition;
+
+        // Markers left behind by dropped audio still tell us where the timeline is now
+        const auto offset = analysisStreamPosition - marker.streamPosition;
+        loudnessMeter.setTimelinePosition(marker.timelineSample >= 0 ? marker.timelineSample + offset : -1);
+        if (analysisReferenceChannels > 0)
+            referenceMeter.setTimelinePosition(marker.timelineSample >= 0 ? marker.timelineSample + offset : -1);
+        timelineFifo.finishedRead(1);
     }
 
-    DBG("--------------------------------------------------------------");
+    return std::numeric_limits<juce::int64>::max();
 }
 
-//==============================================================================
-// Standard AudioProcessor implementations
-const juce::String DynamicsDoctorProcessor::getName() const { return JucePlugin_Name; }
-bool DynamicsDoctorProcessor::acceptsMidi() const { return false; }
-bool DynamicsDoctorProcessor::producesMidi() const { return false; }
-bool DynamicsDoctorProcessor::isMidiEffect() const { return false; }
+void DynamicsDoctorProcessor::continueLraEvaluation(int maxBins)
+{
+    if (! lraEvaluationPending.load())
+        return;
+
+    bool finished;
+    {
+        const ScopedTimingSample queryTimer (lraQueryTiming, timingEnabled);
+        finished = loudnessMeter.continueLoudnessRange(maxBins);
+        if (analysisReferenceChannels > 0)
+            finished = referenceMeter.continueLoudnessRange(maxBins) && finished;
+    }
+
+    if (finished)
+    {
+        lraEvaluationPending.store(false);
+        publishLRA(loudnessMeter.getLastLoudnessRange());
+    }
+}
+
+void DynamicsDoctorProcessor::publishLRA(float lra)
+{
+    // Band histograms are evaluated in full with each query: a fixed 1000 bins per band
+    const auto bands = loudnessMeter.getBandSummary();
+    for (int band = 0; band < MultibandLoudness::numBands; ++band)
+    {
+        bandLRAs[static_cast<size_t>(band)].store(bands.lra[static_cast<size_t>(band)]);
+        bandShortTermLUFS[static_cast<size_t>(band)].store(bands.shortTermLUFS[static_cast<size_t>(band)]);
+    }
+    bandsAvailable.store(bands.isAvailable);
+
+    const auto micro = loudnessMeter.getMicroDynamics();
+    currentPSR.store(micro.psr);
+    lowestPSR.store(micro.lowestPsr);
+    currentPLR.store(micro.plr);
+    currentCrest.store(micro.crestFactor);
+    maxPeakDb.store(micro.maxPeakDb);
+    microDynamicsAvailable.store(micro.isAvailable);
+
+    // The reference was queried on the same sample, so the two cover the same audio
+    if (analysisReferenceChannels > 0)
+    {
+        const auto referenceMicro = referenceMeter.getMicroDynamics();
+        ReferenceComparison comparison;
+        comparison.isAvailable = micro.isAvailable && referenceMicro.isAvailable;
+        comparison.lra = lra;
+        comparison.plr = micro.plr;
+        comparison.referenceLRA = referenceMeter.getLastLoudnessRange();
+        comparison.referencePLR = referenceMicro.plr;
+        referenceComparison.publish(comparison);
+    }
+
+    analysedLRA.store(lra);
+    lraUpdateCount.fetch_add(1);
+
+    updateAnalysisTier(lra);
+}
+
+void DynamicsDoctorProcessor::restorePendingMeasurement()
+{
+    if (pendingMeasurement.isEmpty())
+        return;
+
+    // One full evaluation of the restored histogram, so the verdict is there at once
+    juce::MemoryInputStream input (pendingMeasurement, false);
+    if (loudnessMeter.restoreSnapshot(input))
+    {
+        measurementRestored.store(true);
+        publishLRA(loudnessMeter.getLoudnessRange());
+        DBG("restorePendingMeasurement: Measurement restored from the saved state.");
+    }
+    else
+    {
+        DBG("restorePendingMeasurement: Saved measurement doesn't match the current mode; measuring afresh.");
+    }
+
+    pendingMeasurement.reset();
+}
+
+//==============================================================================
+void DynamicsDoctorProcessor::setAnalysisTier(AnalysisTier newTier)
+{
+    if (newTier == analysisTier)
+        return;
+
+    analysisTier = newTier;
+    stableLraSeconds = 0.0;
+
+    if (newTier == AnalysisTier::Full)
+    {
+        // Query on the next sample so the verdict catches up immediately
+        restartLraSchedule(analysisClock);
+        DBG("Analysis tier: Full");
+    }
+    else
+    {
+        // Maps the unweighted energy level to loudness while the meter isn't fed
+        economyReferenceLevelDb = lastEnergyLevelDb;
+        economyLoudnessOffsetDb = loudnessMeter.getShortTermLoudness() - lastEnergyLevelDb;
+        DBG("Analysis tier: Economy (reference level " << economyReferenceLevelDb << " dB)");
+    }
+}
+
+void DynamicsDoctorProcessor::updateAnalysisTier(float lra)
+{
+    const auto status = currentStatus.load();
+    const bool isActiveStatus = (status == DynamicsStatus::Ok || status == DynamicsStatus::Reduced
+                                 || status == DynamicsStatus::Loss);
+
+    // Close to a threshold the verdict may flip, so it needs full-rate queries
+    const PresetRegistry::ReadScope presetScope (*presetRegistry);
+    const auto& preset = getSelectedPreset();
+    const float distanceToThreshold = juce::jmin(std::abs(lra - preset.lraThresholdRed),
+                                                 std::abs(lra - preset.lraThresholdAmber));
+    const bool isNearThreshold = distanceToThreshold < TIER_THRESHOLD_MARGIN_LU;
+
+    if (analysisTier == AnalysisTier::Economy)
+    {
+        if (isNearThreshold || ! isActiveStatus)
+            setAnalysisTier(AnalysisTier::Full);
+        return;
+    }
+
+    // A reference is compared sample for sample, so both meters must keep filtering
+    if (editorShowing.load() || ! isActiveStatus || isNearThreshold || analysisReferenceChannels > 0)
+    {
+        stableLraSeconds = 0.0;
+        return;
+    }
+
+    stableLraSeconds += getLraPeriodSamples() / analysisSampleRate;
+    if (stableLraSeconds >= TIER_STABLE_SECONDS && std::isfinite(loudnessMeter.getShortTermLoudness()))
+        setAnalysisTier(AnalysisTier::Economy);
+}
+
+double DynamicsDoctorProcessor::getLraPeriodSamples() const
+{
+    const int rateIndex = (lraRateParam != nullptr) ? static_cast<int>(lraRateParam->load()) : ParameterDefaults::lraRate;
+    const auto& option = lraRates[static_cast<size_t>(juce::jlimit(0, static_cast<int>(lraRates.size()) - 1, rateIndex))];
+    const double period = juce::jmax(1.0, analysisSampleRate / option.hz);
+
+    // Economy never queries faster than its own period, but a slower user rate wins
+    return (analysisTier == AnalysisTier::Economy) ? juce::jmax(period, economyLraPeriodSamples)
+                                                   : period;
+}
+
+void DynamicsDoctorProcessor::restartLraSchedule(juce::int64 firstDeadline)
+{
+    lraSchedule.start(firstDeadline, getLraPeriodSamples());
+}
+
+juce::int64 DynamicsDoctorProcessor::getStaggeredLraDelay() const
+{
+    // Spread the instances of a session over the interval (golden-ratio sequence),
+    // so their LRA queries don't all land on the same block
+    const double phase = std::fmod(juce::jmax(0, sessionSlot) * 0.6180339887498949, 1.0);
+    return static_cast<juce::int64>(phase * getLraPeriodSamples());
+}
+
+void DynamicsDoctorProcessor::trackEconomyEnergy(const juce::AudioBuffer<float>& block)
+{
+    // Plain (unweighted) energy over one-second windows: far cheaper than a
+    // loudness query and enough to notice that the programme has changed.
+    for (int ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        const float rms = block.getRMSLevel(ch, 0, block.getNumSamples());
+        energyWindowSum += static_cast<double>(rms) * rms * block.getNumSamples();
+    }
+    energyWindowSamples += block.getNumSamples();
+
+    if (energyWindowSamples < energyWindowLengthSamples)
+        return;
+
+    const auto meanSquare = energyWindowSum / (energyWindowSamples * juce::jmax(1, block.getNumChannels()));
+    lastEnergyLevelDb = juce::Decibels::gainToDecibels(static_cast<float>(std::sqrt(meanSquare)));
+    energyWindowSum = 0.0;
+    energyWindowSamples = 0;
+
+    if (analysisTier == AnalysisTier::Economy
+        && std::abs(lastEnergyLevelDb - economyReferenceLevelDb) > TIER_PROMOTE_LEVEL_CHANGE_DB)
+    {
+        setAnalysisTier(AnalysisTier::Full);
+    }
+}
+
+bool DynamicsDoctorProcessor::hasPendingAnalysis() const noexcept
+{
+    if (analysisResetPending.load() || lraEvaluationPending.load())
+        return true;
+
+    // Economy instances are drained in larger, less frequent batches
+    // (unless the editor just opened and is waiting for a promotion)
+    const bool drainInBatches = ((analysisTier.load() == AnalysisTier::Economy) && ! editorShowing.load())
+                                || offlineRenderActive.load();
+    const int batchThreshold = drainInBatches ? analysisFifo.getTotalSize() / 4 : 1;
+    return analysisFifo.getNumReady() >= batchThreshold;
+}
+
+void DynamicsDoctorProcessor::writeCheckpoint()
+{
+    if (! isMeasurementSaved())
+        return;
+
+    // Copy the history out while the analysis side is between slices; if it is
+    // busy, the next pass will catch it. Nothing here waits on another thread.
+    const auto updateCount = lraUpdateCount.load();
+    bool hasMeasurement = false;
+    {
+        const juce::SpinLock::ScopedTryLockType lock (analysisLock);
+        if (! lock.isLocked() || ! pendingMeasurement.isEmpty())
+            return; // Busy, or a loaded measurement hasn't been restored yet
+
+        hasMeasurement = analysisSampleRate > 0.0 && ! analysisResetPending.load() && ! isInitialMeasuringPhase.load();
+        if (hasMeasurement == lastCheckpointHadMeasurement && updateCount == lastCheckpointUpdate)
+            return; // Nothing new since the last checkpoint
+
+        if (hasMeasurement)
+        {
+            juce::MemoryOutputStream output (checkpointData, false);
+            loudnessMeter.writeSnapshot(output);
+        }
+        else
+        {
+            checkpointData.setSize(0); // Reset since: recover to a fresh measurement
+        }
+    }
+
+    if (checkpoint.write(checkpointData, juce::Time::currentTimeMillis()))
+    {
+        lastCheckpointUpdate = updateCount;
+        lastCheckpointHadMeasurement = hasMeasurement;
+    }
+    else
+    {
+        DBG("writeCheckpoint: Could not write the checkpoint file.");
+    }
+}
+
+bool DynamicsDoctorProcessor::isAnalysisHighPriority() const noexcept
+{
+    return editorShowing.load();
+}
+
+void DynamicsDoctorProcessor::setEditorShowing (bool isShowing)
+{
+    editorShowing.store(isShowing);
+}
+
+//==============================================================================
+void DynamicsDoctorProcessor::setTimingEnabled (bool shouldBeEnabled)
+{
+    timingEnabled.store(shouldBeEnabled);
+}
+
+bool DynamicsDoctorProcessor::isTimingEnabled() const
+{
+    return timingEnabled.load();
+}
+
+void DynamicsDoctorProcessor::resetTiming()
+{
+    callbackTiming.reset();
+    meterTiming.reset();
+    lraQueryTiming.reset();
+}
+
+juce::String DynamicsDoctorProcessor::getTimingSummary() const
+{
+    const auto summary = callbackTiming.summarise();
+    const double deadline = blockDeadlineMicros.load();
+    if (summary.count == 0 || deadline <= 0.0)
+        return "DSP: no data";
+
+    // Percent of the block deadline: 100% would be a dropout
+    auto percent = [deadline] (double micros) { return juce::String(100.0 * micros / deadline, 1) + "%"; };
+    return "DSP p50 " + percent(summary.p50Micros)
+         + "  p99 " + percent(summary.p99Micros)
+         + "  max " + percent(summary.maxMicros);
+}
+
+juce::String DynamicsDoctorProcessor::createTimingReport() const
+{
+    const double deadline = blockDeadlineMicros.load();
+    juce::String report;
+    report << "DynamicsDoctor timing report - " << juce::Time::getCurrentTime().toString(true, true) << "\n"
+           << "Sample rate: " << internalSampleRate << " Hz, block deadline: " << juce::String(deadline, 1) << " us\n"
+           << "Analysis queue overruns: " << analysisOverruns.load() << "\n";
+
+    auto describe = [&report, deadline] (const juce::String& name, const TimingHistogram& histogram)
+    {
+        const auto summary = histogram.summarise();
+        report << "\n" << name << " (" << juce::String(static_cast<juce::int64>(summary.count)) << " samples)\n";
+
+        auto line = [&report, deadline] (const char* label, double micros)
+        {
+            report << "  " << label << juce::String(micros, 2) << " us";
+            if (deadline > 0.0)
+                report << " (" << juce::String(100.0 * micros / deadline, 2) << "% of deadline)";
+            report << "\n";
+        };
+
+        line("p50: ", summary.p50Micros);
+        line("p99: ", summary.p99Micros);
+        line("max: ", summary.maxMicros);
+        report << histogram.describeBuckets();
+    };
+
+    describe("processBlock", callbackTiming);
+    describe("Meter (per analysed chunk, pool thread)", meterTiming);
+    describe("LRA evaluation step (pool thread)", lraQueryTiming);
+    return report;
+}
+
+juce::String DynamicsDoctorProcessor::createSessionReport() const
+{
+    juce::String report = createTimingReport() + "\n";
+
+    report << "Micro-dynamics (" << getSelectedPreset().label << ")\n"
+           << describeMicroDynamics() << "\n\n";
+
+    const auto bands = getBandSummary();
+    if (bands.isAvailable)
+        report << "Bands (LRA " << juce::String(currentGlobalLRA.load(), 1) << " LU full band)\n"
+               << bands.describe(currentGlobalLRA.load()) << "\n\n";
+
+    if (isReferenceConnected())
+        report << "Reference input\n" << getReferenceComparison().describe() << "\n\n";
+
+    report << describeExposure() << "\n"
+           << "Monitor calibration: " << juce::String(monitorCalibrationParam->load(), 1) << " dB SPL at -20 LUFS\n\n";
+
+    return report + eventJournal.createReport();
+}
+
+juce::File DynamicsDoctorProcessor::writeSessionReport() const
+{
+    auto file = getReportDirectory().getNonexistentChildFile("Session " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S"), ".txt");
+
+    if (! file.replaceWithText(createSessionReport()))
+    {
+        DBG("writeSessionReport: Could not write " << file.getFullPathName());
+        return {};
+    }
+
+    return file;
+}
+
+//==============================================================================
+void DynamicsDoctorProcessor::beginOfflineRender()
+{
+    renderStartMs = juce::Time::currentTimeMillis();
+    renderSamples.store(0);
+    renderPeakGain.store(0.0f);
+    offlineRenderActive.store(true);
+
+    eventJournal.record(EventJournal::Type::Render, blockStartSample.load(), currentGlobalLRA.load(), 0, 1);
+    DBG("Offline render started: LRA deferred until the end of the render.");
+}
+
+void DynamicsDoctorProcessor::finishOfflineRender()
+{
+    if (! offlineRenderActive.load())
+        return;
+
+    float lra = 0.0f;
+    bool evaluated = false;
+    {
+        // Message thread: a pool worker holds the lock for one slice at most
+        const juce::SpinLock::ScopedLockType lock (analysisLock);
+
+        if (! analysisResetPending.load())
+        {
+            // Meter whatever the render left in the queue
+            while (analysisFifo.getNumReady() > 0)
+            {
+                const int numToRead = juce::jmin(analysisFifo.getNumReady(), MAX_SAMPLES_PER_ANALYSIS_SLICE * OFFLINE_SLICE_FACTOR);
+                int start1, size1, start2, size2;
+                analysisFifo.prepareToRead(numToRead, start1, size1, start2, size2);
+                analyseQueuedRange(start1, size1);
+                analyseQueuedRange(start2, size2);
+                analysisFifo.finishedRead(size1 + size2);
+            }
+
+            // One evaluation over the complete histogram instead of sliced ones
+            {
+                const ScopedTimingSample queryTimer (lraQueryTiming, timingEnabled);
+                lra = loudnessMeter.getLoudnessRange();
+                if (analysisReferenceChannels > 0)
+                    referenceMeter.getLoudnessRange();
+            }
+            lraEvaluationPending.store(false);
+            publishLRA(lra);
+            evaluated = true;
+
+            // The rendered audio was never heard
+            double exposureEnergy = 0.0;
+            int exposureSeconds = 0;
+            loudnessMeter.takeExposure(exposureEnergy, exposureSeconds);
+        }
+
+        offlineRenderActive.store(false);
+        restartLraSchedule(analysisClock + static_cast<juce::int64>(getLraPeriodSamples()));
+    }
+
+    eventJournal.record(EventJournal::Type::Render, blockStartSample.load(), lra, 1, 0);
+
+    if (! evaluated)
+    {
+        DBG("Offline render finished during a reset: no render report.");
+        return;
+    }
+
+    auto file = getReportDirectory().getNonexistentChildFile("Render " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S"), ".txt");
+    if (! file.replaceWithText(createRenderReport(lra)))
+        DBG("finishOfflineRender: Could not write " << file.getFullPathName());
+    else
+        DBG("Offline render finished, report written to " << file.getFullPathName());
+}
+
+juce::String DynamicsDoctorProcessor::createRenderReport (float lra) const
+{
+    const double renderedSeconds = (internalSampleRate > 0.0) ? renderSamples.load() / internalSampleRate : 0.0;
+    const double wallSeconds = (juce::Time::currentTimeMillis() - renderStartMs) / 1000.0;
+
+    juce::String report;
+    report << "DynamicsDoctor render report - " << juce::Time::getCurrentTime().toString(true, true) << "\n"
+           << "Rendered: " << juce::String(renderedSeconds, 1) << " s of audio in " << juce::String(wallSeconds, 1) << " s";
+    if (wallSeconds > 0.0)
+        report << " (" << juce::String(renderedSeconds / wallSeconds, 1) << "x real time)";
+    report << "\n"
+           << "Sample rate: " << internalSampleRate << " Hz\n"
+           << "Peak: " << juce::String(juce::Decibels::gainToDecibels(renderPeakGain.load()), 1) << " dBFS\n"
+           << "Loudness range: " << juce::String(lra, 2) << " LU (full evaluation at the end of the render)\n"
+           << "Analysis queue overruns: " << analysisOverruns.load() << "\n";
+
+    // Every preset judged on the final value, without hysteresis or dwell
+    const auto& table = presetRegistry->getTable();
+    const auto verdicts = PresetVerdicts::evaluate(table, lra);
+    report << "\nPresets\n";
+    for (int i = 0; i < static_cast<int>(table.presets.size()); ++i)
+    {
+        if (! table.isListed(i))
+            continue;
+
+        const auto& preset = table.presets[static_cast<size_t>(i)];
+        report << "  " << preset.label << ": " << getStatusMessage(verdicts.getStatus(i));
+        if (verdicts.isBelowTarget(i))
+            report << ", below target";
+        else if (verdicts.isAboveTarget(i))
+            report << ", above target";
+        report << " (target " << juce::String(preset.targetLraMin, 1) << "-" << juce::String(preset.targetLraMax, 1) << " LU)\n";
+    }
+
+    report << "\nMicro-dynamics (" << getSelectedPreset().label << ")\n"
+           << describeMicroDynamics() << "\n";
+
+    const auto bands = getBandSummary();
+    if (bands.isAvailable)
+        report << "\nBands\n" << bands.describe(lra) << "\n";
+
+    return report;
+}
+
+//==============================================================================
+int DynamicsDoctorProcessor::getSelectedPresetIndex() const
+{
+    // A user preset chosen in the editor, otherwise the parameter's built-in one
+    const int userIndex = userPresetIndex.load();
+    const int presetIndex = (userIndex >= 0) ? userIndex
+                          : (presetParam != nullptr) ? static_cast<int>(presetParam->load()) : ParameterDefaults::preset;
+
+    const PresetRegistry::ReadScope presetScope (*presetRegistry);
+    return presetRegistry->getTable().getValidIndex(presetIndex);
+}
+
+void DynamicsDoctorProcessor::selectPreset(int tableIndex)
+{
+    if (tableIndex < static_cast<int>(builtInPresets.size()))
+    {
+        // Built-ins go through the parameter, so the host can automate and recall them
+        userPresetIndex.store(-1);
+        if (auto* parameter = parameters.getParameter(ParameterIDs::preset.getParamID()))
+        {
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(tableIndex)));
+            parameter->endChangeGesture();
+        }
+    }
+    else
+    {
+        userPresetIndex.store(tableIndex);
+    }
+
+    // The parameter only reports a change of value
+    presetSelectionChanged();
+}
+
+void DynamicsDoctorProcessor::presetSelectionChanged()
+{
+    const int newIndex = getSelectedPresetIndex();
+    const int oldIndex = lastPresetIndex.exchange(newIndex);
+    if (newIndex == oldIndex)
+        return;
+
+    DBG("PROCESSOR: Preset changed. Showing its verdict for the current measurement.");
+    eventJournal.record(EventJournal::Type::PresetChanged, blockStartSample.load(), currentGlobalLRA.load(), oldIndex, newIndex);
+    applySelectedPresetVerdict();
+}
+
+const DynamicsPreset& DynamicsDoctorProcessor::getSelectedPreset() const
+{
+    return presetRegistry->getTable().getPreset(getSelectedPresetIndex());
+}
+
+void DynamicsDoctorProcessor::updateStatusBasedOnLRA(float measuredLRA)
+{
+    if (presetParam == nullptr) {
+        setStatus(DynamicsStatus::Ok);
+        return;
+    }
+
+    // Judge every preset against the same measurement, so switching is just a lookup.
+    // The filter holds a status until the LRA has clearly moved past a threshold.
+    // Table and selected index come from one scope, so they belong to the same reload.
+    const PresetRegistry::ReadScope presetScope (*presetRegistry);
+    const auto& table = presetRegistry->getTable();
+    const auto verdicts = statusFilter.process(table, measuredLRA, audioClock);
+    presetVerdicts.store(verdicts.getPacked());
+    setStatus(verdicts.getStatus(table.getValidIndex(getSelectedPresetIndex())));
+}
+
+void DynamicsDoctorProcessor::applySelectedPresetVerdict()
+{
+    const PresetVerdicts verdicts (presetVerdicts.load());
+    const int presetIndex = getSelectedPresetIndex();
+    if (! verdicts.hasVerdict(presetIndex))
+        return;
+
+    // Only a finished measurement has a verdict to show; the audio thread may be
+    // moving the state machine at the same time, so never overwrite other states
+    const auto newStatus = verdicts.getStatus(presetIndex);
+    auto status = currentStatus.load();
+    while ((status == DynamicsStatus::Ok || status == DynamicsStatus::Reduced || status == DynamicsStatus::Loss)
+           && ! currentStatus.compare_exchange_weak(status, newStatus))
+    {
+    }
+
+    const bool replaced = (status == DynamicsStatus::Ok || status == DynamicsStatus::Reduced || status == DynamicsStatus::Loss);
+    if (replaced && status != newStatus)
+    {
+        eventJournal.record(EventJournal::Type::StatusChanged, blockStartSample.load(), currentGlobalLRA.load(),
+                            static_cast<int>(status), static_cast<int>(newStatus));
+        publishAnalysisSnapshot();
+    }
+}
+
+void DynamicsDoctorProcessor::setStatus(DynamicsStatus newStatus)
+{
+    const auto previous = currentStatus.exchange(newStatus);
+    if (previous != newStatus)
+        eventJournal.record(EventJournal::Type::StatusChanged, blockStartSample.load(), currentGlobalLRA.load(),
+                            static_cast<int>(previous), static_cast<int>(newStatus));
+}
+
+//==============================================================================
+void DynamicsDoctorProcessor::handleResetLRA()
+{
+    DBG("    **********************************************************");
+    DBG("    PROCESSOR: handleResetLRA() - Entered.");
+
+    // Validate sample rate (not prepared yet)
+    if (internalSampleRate <= 0.0) {
+        DBG("    PROCESSOR: handleResetLRA() - ABORTING: Invalid sample rate: " << internalSampleRate);
+        DBG("    **********************************************************");
+        return;
+    }
+
+    eventJournal.record(EventJournal::Type::Reset, blockStartSample.load(), currentGlobalLRA.load());
+
+    // Ask the analysis side to restart the meter; it owns the meter while the pool runs
+    analysisResetPending.store(true);
+    currentGlobalLRA.store(0.0f);
+
+    samplesProcessedSinceReset.store(0);
+    presetVerdicts.store(0);
+    setStatus(DynamicsStatus::AwaitingAudio);  // Set to awaiting audio state
+    
+    // Reset audio state monitoring
+    samplesSinceLastAudio.store(0);
+    waitingForNextAudio.store(true);
+    isInitialMeasuringPhase.store(true);
+
+    DBG("handleResetLRA: currentStatus set to AwaitingAudio. Waiting for audio signal.");
+    publishAnalysisSnapshot(); // Shown at once, even if the host is not calling processBlock
+    DBG("    PROCESSOR: handleResetLRA() - Reset complete.");
+    DBG("    **********************************************************");
+}
+
+//==============================================================================
+void DynamicsDoctorProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    DBG("--------------------------------------------------------------");
+    DBG("PROCESSOR: parameterChanged - Parameter: '" << parameterID
+        << "', Value: " << newValue << (newValue > 0.5f ? " (TRUE)" : " (FALSE)"));
+
+    // Handle reset button
+    if (parameterID == ParameterIDs::resetLra.getParamID())
+    {
+        if (newValue > 0.5f)
+        {
+            DBG("PROCESSOR: Reset triggered. Calling handleResetLRA()");
+            handleResetLRA();
+            
+            // Reset button state
+            if (resetLraParamObject != nullptr)
+            {
+                resetLraParamObject->beginChangeGesture();
+                resetLraParamObject->setValueNotifyingHost(0.0f);
+                resetLraParamObject->endChangeGesture();
+            }
+            else
+            {
+                auto* paramToReset = static_cast<juce::AudioParameterBool*>(
+                    parameters.getParameter(ParameterIDs::resetLra.getParamID()));
+                if (paramToReset != nullptr) {
+                    paramToReset->beginChangeGesture();
+                    paramToReset->setValueNotifyingHost(0.0f);
+                    paramToReset->endChangeGesture();
+                } else {
+                    DBG("PROCESSOR: ERROR - Reset parameter not found!");
+                    jassertfalse;
+                }
+            }
+        }
+    }
+    // Handle preset changes: the measurement doesn't depend on the preset, so keep it
+    else if (parameterID == ParameterIDs::preset.getParamID())
+    {
+        // The host picking a built-in replaces a user preset chosen in the editor
+        userPresetIndex.store(-1);
+        presetSelectionChanged();
+    }
+    // Band histories only exist from the start of a measurement
+    else if (parameterID == ParameterIDs::bandAnalysis.getParamID())
+    {
+        DBG("PROCESSOR: Band analysis " << (newValue > 0.5f ? "enabled" : "disabled") << ". Resetting measurement.");
+        handleResetLRA();
+    }
+    // Timeline-keyed and block-appended histories don't mix
+    else if (parameterID == ParameterIDs::timelineAligned.getParamID())
+    {
+        DBG("PROCESSOR: Timeline-aligned LRA " << (newValue > 0.5f ? "enabled" : "disabled") << ". Resetting measurement.");
+        handleResetLRA();
+    }
+    // The meter's analysis rate changes, so the history can't be kept
+    else if (parameterID == ParameterIDs::highRateDecimation.getParamID())
+    {
+        DBG("PROCESSOR: High-rate decimation " << (newValue > 0.5f ? "enabled" : "disabled") << ". Resetting measurement.");
+        handleResetLRA();
+    }
+
+    DBG("--------------------------------------------------------------");
+}
+
+//==============================================================================
+// Standard AudioProcessor implementations
+const juce::String DynamicsDoctorProcessor::getName() const { return JucePlugin_Name; }
+bool DynamicsDoctorProcessor::acceptsMidi() const { return false; }
+bool DynamicsDoctorProcessor::producesMidi() const { return false; }
+bool DynamicsDoctorProcessor::isMidiEffect() const { return false; }
 double DynamicsDoctorProcessor::getTailLengthSeconds() const { return 0.0; }
 int DynamicsDoctorProcessor::getNumPrograms() { return 1; }
 int DynamicsDoctorProcessor::getCurrentProgram() { return 0; }
@@ -449,26 +1616,236 @@ juce::AudioProcessorEditor* DynamicsDoctorProcessor::createEditor()
 void DynamicsDoctorProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
     auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    copyXmlToBinary (*xml, destData);
+    state.appendChild(exposureDose.toValueTree(), nullptr); // So that a day's dose survives reopening the project
+
+    // Lets a later load find a crash checkpoint written after this save
+    state.setProperty(CHECKPOINT_ID_PROPERTY, checkpoint.getId(), nullptr);
+    state.setProperty(SAVED_AT_PROPERTY, juce::Time::currentTimeMillis(), nullptr);
+
+    // A user preset by id, since its slot only holds for this process
+    const int userIndex = userPresetIndex.load();
+    if (userIndex >= 0)
+    {
+        const PresetRegistry::ReadScope presetScope (*presetRegistry);
+        const auto& table = presetRegistry->getTable();
+        if (juce::isPositiveAndBelow(userIndex, static_cast<int>(table.presets.size())))
+            state.setProperty(USER_PRESET_PROPERTY, juce::String(table.presets[static_cast<size_t>(userIndex)].id), nullptr);
+    }
+
+    // The LRA history, once there is a finished measurement to keep. The lock is
+    // only contended by pool workers (they skip us); the copy is a few kilobytes.
+    juce::MemoryBlock measurement;
+    if (isMeasurementSaved())
+    {
+        const juce::SpinLock::ScopedLockType lock (analysisLock);
+
+        if (! pendingMeasurement.isEmpty())
+        {
+            measurement = pendingMeasurement; // Loaded but not restored yet (not prepared)
+        }
+        else if (analysisSampleRate > 0.0 && ! analysisResetPending.load() && ! isInitialMeasuringPhase.load())
+        {
+            juce::MemoryOutputStream output (measurement, false);
+            loudnessMeter.writeSnapshot(output);
+        }
+    }
+
+    PluginState::write(state, measurement, destData);
 }
 
 void DynamicsDoctorProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
-    
-    if (xmlState != nullptr && xmlState->hasTagName (parameters.state.getType()))
+    juce::ValueTree state;
+    juce::MemoryBlock measurement;
+
+    if (! PluginState::read(data, sizeInBytes, state, measurement))
+    {
+        // Saved by a build that wrote XML
+        if (auto xmlState = getXmlFromBinary (data, sizeInBytes))
+            state = juce::ValueTree::fromXml (*xmlState);
+    }
+
+    if (state.hasType (parameters.state.getType()))
     {
         DBG("setStateInformation: Loading state...");
-        parameters.replaceState (juce::ValueTree::fromXml (*xmlState));
+        const auto exposure = state.getChildWithName(ExposureDose::stateType);
+        if (exposure.isValid())
+        {
+            exposureDose.restore(exposure);
+            state.removeChild(exposure, nullptr);
+        }
+
+        const auto checkpointId = state.getProperty(CHECKPOINT_ID_PROPERTY).toString();
+        const juce::int64 savedAtMs = state.getProperty(SAVED_AT_PROPERTY, 0);
+        const auto userPresetId = state.getProperty(USER_PRESET_PROPERTY).toString();
+        state.removeProperty(CHECKPOINT_ID_PROPERTY, nullptr);
+        state.removeProperty(SAVED_AT_PROPERTY, nullptr);
+        state.removeProperty(USER_PRESET_PROPERTY, nullptr);
+
+        parameters.replaceState (state);
         handleResetLRA();
+
+        // Falls back to the saved built-in if the user preset isn't in the file (any more)
+        userPresetIndex.store(-1);
+        if (userPresetId.isNotEmpty())
+        {
+            const PresetRegistry::ReadScope presetScope (*presetRegistry);
+            const auto& table = presetRegistry->getTable();
+            const int tableIndex = table.findPreset(userPresetId.toStdString());
+            if (table.isListed(tableIndex))
+                userPresetIndex.store(tableIndex);
+            else
+                DBG("setStateInformation: User preset " << userPresetId << " not found, using the saved built-in preset.");
+        }
+        presetSelectionChanged();
+
+        // Crash recovery: a checkpoint written after this state was saved is the later measurement
+        if (checkpointId.isNotEmpty() && checkpoint.adoptId(checkpointId) && isMeasurementSaved())
+        {
+            juce::MemoryBlock recovered;
+            juce::int64 checkpointTimeMs = 0;
+            if (checkpoint.read(recovered, checkpointTimeMs) && checkpointTimeMs > savedAtMs)
+            {
+                DBG("setStateInformation: Recovering the measurement from a checkpoint of "
+                    << juce::Time(checkpointTimeMs).toString(true, true));
+                measurement.swapWith(recovered);
+            }
+        }
+
+        // Handed over once the reset above has settled the status. Whichever
+        // restart runs after this picks it up: the one just requested, another
+        // one if that has already run, or prepareToPlay if we aren't prepared.
+        const bool hasMeasurement = ! measurement.isEmpty();
+        const juce::SpinLock::ScopedLockType lock (analysisLock);
+        pendingMeasurement.swapWith(measurement);
+        if (hasMeasurement && internalSampleRate > 0.0)
+            analysisResetPending.store(true);
     }
 }
 
+void DynamicsDoctorProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    sessionRegistry->setSlotName(sessionSlot, properties.name.value_or(juce::String()));
+}
+
 //==============================================================================
 juce::AudioProcessorValueTreeState& DynamicsDoctorProcessor::getValueTreeState() { return parameters; }
 DynamicsStatus DynamicsDoctorProcessor::getCurrentStatus() const { return currentStatus.load(); }
 float DynamicsDoctorProcessor::getReportedLRA() const { return currentGlobalLRA.load(); }
+SessionRegistry& DynamicsDoctorProcessor::getSessionRegistry() { return *sessionRegistry; }
+bool DynamicsDoctorProcessor::isTimelineAligned() const { return timelineParam != nullptr && timelineParam->load() > 0.5f; }
+bool DynamicsDoctorProcessor::isMeasurementSaved() const { return saveMeasurementParam != nullptr && saveMeasurementParam->load() > 0.5f; }
+bool DynamicsDoctorProcessor::isMeterOutputEnabled() const { return meterOutputParam != nullptr && meterOutputParam->load() > 0.5f; }
+bool DynamicsDoctorProcessor::isBandAnalysisEnabled() const { return bandAnalysisParam != nullptr && bandAnalysisParam->load() > 0.5f; }
+
+void DynamicsDoctorProcessor::configureMeter()
+{
+    loudnessMeter.setDecimationEnabled(decimationParam == nullptr || decimationParam->load() > 0.5f);
+    loudnessMeter.setTimelineAligned(isTimelineAligned());
+    loudnessMeter.setMultibandEnabled(isBandAnalysisEnabled());
+
+    // The reference only needs the full-band measurement
+    referenceMeter.setDecimationEnabled(decimationParam == nullptr || decimationParam->load() > 0.5f);
+    referenceMeter.setTimelineAligned(isTimelineAligned());
+}
+
+MicroDynamicsTracker::Summary DynamicsDoctorProcessor::getMicroDynamics() const
+{
+    MicroDynamicsTracker::Summary summary;
+    if (analysisResetPending.load() || ! microDynamicsAvailable.load())
+        return summary;
+
+    summary.isAvailable = true;
+    summary.psr = currentPSR.load();
+    summary.lowestPsr = lowestPSR.load();
+    summary.plr = currentPLR.load();
+    summary.crestFactor = currentCrest.load();
+    summary.maxPeakDb = maxPeakDb.load();
+    return summary;
+}
+
+float DynamicsDoctorProcessor::getMonitorCalibration() const { return monitorCalibrationParam->load(); }
+
+bool DynamicsDoctorProcessor::isReferenceConnected() const { return referenceConnected.load(); }
+
+ReferenceComparison DynamicsDoctorProcessor::getReferenceComparison() const
+{
+    // Not available while a reset is pending, or if no consistent copy could be taken
+    ReferenceComparison comparison;
+    if (analysisResetPending.load() || ! referenceComparison.read(comparison))
+        return {};
+
+    return comparison;
+}
+
+const ExposureDose::Standard& DynamicsDoctorProcessor::getExposureStandard() const
+{
+    return ExposureDose::getStandard(static_cast<int>(exposureStandardParam->load()));
+}
+
+ExposureDose::Reading DynamicsDoctorProcessor::getExposureReading() const
+{
+    return exposureDose.getReading(static_cast<int>(exposureStandardParam->load()), monitorCalibrationParam->load());
+}
+
+juce::String DynamicsDoctorProcessor::describeExposure() const
+{
+    return getExposureReading().describe(getExposureStandard());
+}
+
+void DynamicsDoctorProcessor::clearExposure() { exposureDose.clear(); }
+
+bool DynamicsDoctorProcessor::isOverLimited() const
+{
+    return getMicroDynamics().isBelowMinimum(getSelectedPreset());
+}
+
+juce::String DynamicsDoctorProcessor::describeMicroDynamics() const
+{
+    return getMicroDynamics().describe(getSelectedPreset());
+}
+
+MultibandLoudness::Summary DynamicsDoctorProcessor::getBandSummary() const
+{
+    MultibandLoudness::Summary summary;
+    if (analysisResetPending.load() || ! bandsAvailable.load())
+        return summary;
+
+    summary.isAvailable = true;
+    for (int band = 0; band < MultibandLoudness::numBands; ++band)
+    {
+        summary.lra[static_cast<size_t>(band)] = bandLRAs[static_cast<size_t>(band)].load();
+        summary.shortTermLUFS[static_cast<size_t>(band)] = bandShortTermLUFS[static_cast<size_t>(band)].load();
+    }
+    return summary;
+}
+bool DynamicsDoctorProcessor::isTransportPaused() const { return transportPaused.load(); }
+bool DynamicsDoctorProcessor::readAnalysisSnapshot(AnalysisSnapshot& snapshot) const { return analysisSnapshot.read(snapshot); }
+PresetRegistry& DynamicsDoctorProcessor::getPresetRegistry() { return *presetRegistry; }
+EventJournal& DynamicsDoctorProcessor::getEventJournal() { return eventJournal; }
+PresetVerdicts DynamicsDoctorProcessor::getPresetVerdicts() const { return PresetVerdicts(presetVerdicts.load()); }
+
+LoudnessRangeEstimator::Estimate DynamicsDoctorProcessor::getProvisionalLRA() const
+{
+    // Until the analysis side has restarted the meter, the estimate is the old measurement's
+    LoudnessRangeEstimator::Estimate estimate;
+    if (analysisResetPending.load())
+        return estimate;
+
+    estimate.lra = provisionalLRA.load();
+    estimate.halfWidth = provisionalHalfWidth.load();
+    estimate.numValues = provisionalValueCount.load();
+    return estimate;
+}
+
+DynamicsStatus DynamicsDoctorProcessor::getProvisionalStatus() const
+{
+    if (currentStatus.load() != DynamicsStatus::Measuring)
+        return DynamicsStatus::Measuring;
+
+    const auto estimate = getProvisionalLRA();
+    return estimate.isUsable() ? PresetVerdicts::judge(getSelectedPreset(), estimate.lra) : DynamicsStatus::Measuring;
+}
 
 bool DynamicsDoctorProcessor::isCurrentlyBypassed() const
 {
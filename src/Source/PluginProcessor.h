@@ -5,10 +5,23 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <atomic>
+#include <array>
+#include <limits>
 
 // Project-specific headers
 #include "Constants.h"
 #include "LoudnessMeter.h"
+#include "SessionRegistry.h"
+#include "AnalysisWorkerPool.h"
+#include "TimingHistogram.h"
+#include "SampleClock.h"
+#include "PresetRegistry.h"
+#include "StatusFilter.h"
+#include "EventJournal.h"
+#include "ExposureDose.h"
+#include "MeasurementCheckpoint.h"
+#include "AnalysisSnapshot.h"
+#include "ReferenceComparison.h"
 
 //==============================================================================
 /**
@@ -23,9 +36,17 @@
  * The processor maintains a state machine that tracks the current dynamics status
  * (Ok, Reduced, Loss, Measuring, Bypassed) based on the measured LRA values
  * and the selected preset's thresholds.
+ *
+ * Loudness analysis does not run on the audio thread: processBlock() queues
+ * each block in a lock-free FIFO, and a slice of the shared AnalysisWorkerPool
+ * feeds it to the LoudnessMeter and publishes the LRA back. During an offline
+ * render the LRA is only evaluated once, when the render finishes.
  */
 class DynamicsDoctorProcessor : public juce::AudioProcessor,
-                              public juce::AudioProcessorValueTreeState::Listener
+                              public juce::AudioProcessorValueTreeState::Listener,
+                              public AnalysisClient,
+                              public CheckpointClient,
+                              private juce::Timer
 {
 public:
     //==============================================================================
@@ -38,6 +59,9 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    /** Offline render (bounce) start and end: switches the analysis to throughput mode */
+    void setNonRealtime (bool shouldBeNonRealtime) noexcept override;
     
     //==============================================================================
     /** Plugin editor management */
@@ -65,20 +89,106 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    /** Host track information, used to label this instance in the session overview */
+    void updateTrackProperties (const TrackProperties& properties) override;
+
     //==============================================================================
     /** Public interface for the editor */
     juce::AudioProcessorValueTreeState& getValueTreeState();
     DynamicsStatus getCurrentStatus() const;
     float getReportedLRA() const;
+    SessionRegistry& getSessionRegistry();
+    PresetRegistry& getPresetRegistry();
+    PresetVerdicts getPresetVerdicts() const;      // Every preset judged against the current LRA
+    int getSelectedPresetIndex() const;            // Table index of the selected preset (lock-free)
+    void selectPreset (int tableIndex);            // Built-ins through the parameter, user presets by slot (message thread)
     
     // <<< ADD THESE NEW PUBLIC GETTERS >>>
     bool isCurrentlyBypassed() const;
+    bool isTransportPaused() const;                // Measurement frozen while the host transport is stopped
+
+    /**
+     * Peak, LRA, status, bypass and transport flags of one block, read together
+     * (see AnalysisSnapshot.h). Never blocks the audio thread.
+     * @return False, leaving the snapshot untouched, if no consistent copy could be taken
+     */
+    bool readAnalysisSnapshot (AnalysisSnapshot& snapshot) const;
+
+    /** Running LRA estimate of the current measurement; not usable until a couple of seconds in */
+    LoudnessRangeEstimator::Estimate getProvisionalLRA() const;
+
+    /** While measuring, the selected preset's verdict on the provisional LRA once it is usable; otherwise Measuring */
+    DynamicsStatus getProvisionalStatus() const;
+
+    /** Per-band short-term loudness and LRA as of the last LRA query; not available unless band analysis is on */
+    MultibandLoudness::Summary getBandSummary() const;
+
+    /** PSR, PLR and crest factor as of the last LRA query */
+    MicroDynamicsTracker::Summary getMicroDynamics() const;
+
+    /** True if the host has enabled the reference (sidechain) input */
+    bool isReferenceConnected() const;
+
+    /** Main input against the reference input as of the last LRA query; not available without a reference */
+    ReferenceComparison getReferenceComparison() const;
+
+    /** True if PSR or PLR is below the selected preset's minimum */
+    bool isOverLimited() const;
+
+    /** getMicroDynamics() against the selected preset's minimums, for tooltips and reports */
+    juce::String describeMicroDynamics() const;
+
+    /** Listening dose so far against the selected standard and monitor calibration */
+    ExposureDose::Reading getExposureReading() const;
+    const ExposureDose::Standard& getExposureStandard() const;
+    float getMonitorCalibration() const;           // dB SPL at the listening position for a -20 LUFS programme
+    juce::String describeExposure() const;
+    void clearExposure();
+
+    /** Called by the editor so the analysis pool can serve visible instances first */
+    void setEditorShowing (bool isShowing);
+
+    /** Timing instrumentation: runtime switch, one-line summary and full report */
+    void setTimingEnabled (bool shouldBeEnabled);
+    bool isTimingEnabled() const;
+    void resetTiming();
+    juce::String getTimingSummary() const;
+    juce::String createTimingReport() const;
+
+    /** Event journal (status transitions, resets, bypass, preset changes) */
+    EventJournal& getEventJournal();
+
+    /** Timing report followed by the event history, written to the report directory */
+    juce::String createSessionReport() const;
+    juce::File writeSessionReport() const;
+
+    /** Report written at the end of each offline render: final LRA and every preset's verdict */
+    juce::String createRenderReport (float lra) const;
+
+    /** True if the next saved state will include the LRA history */
+    bool isMeasurementSaved() const;
+
+    /** True if peak and LRA are sent to the host for its meters and automation lanes */
+    bool isMeterOutputEnabled() const;
+
+    //==============================================================================
+    /** AnalysisClient callbacks, run by the shared analysis pool */
+    bool runAnalysisSlice() override;
+    bool hasPendingAnalysis() const noexcept override;
+    bool isAnalysisHighPriority() const noexcept override;
+
+    /** CheckpointClient callback, run by the shared checkpoint writer */
+    void writeCheckpoint() override;
     
     /** Parameter change callback from the value tree state */
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
 private:
     //==============================================================================
+    /** Built-in and user presets, shared by every instance (used by the parameter layout) */
+    juce::SharedResourcePointer<PresetRegistry> presetRegistry;
+
     /** Parameter management */
     juce::AudioProcessorValueTreeState parameters;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -86,33 +196,242 @@ private:
     /** Real-time parameter access - atomic for thread safety */
     std::atomic<float>* bypassParam = nullptr;      // Bypass state
     std::atomic<float>* presetParam = nullptr;      // Selected preset index
-    std::atomic<float>* peakParam = nullptr;        // Instantaneous peak level in dBFS
-    std::atomic<float>* lraParam = nullptr;         // Long-term loudness range in LU
+    std::atomic<float>* lraRateParam = nullptr;     // Selected LRA evaluation rate (index into lraRates)
+    std::atomic<float>* decimationParam = nullptr;  // Decimate high-rate audio before analysis
+    std::atomic<float>* timelineParam = nullptr;    // Key loudness to the host timeline
+    std::atomic<float>* pauseWithTransportParam = nullptr; // Freeze while the transport is stopped
+    std::atomic<float>* bandAnalysisParam = nullptr; // Per-band analysis in the meter
+    std::atomic<float>* exposureStandardParam = nullptr;   // Index into ExposureDose's standards
+    std::atomic<float>* monitorCalibrationParam = nullptr; // dB SPL for a -20 LUFS programme
+    std::atomic<float>* saveMeasurementParam = nullptr;    // Include the measurement in the saved state
+    std::atomic<float>* meterOutputParam = nullptr;        // Send peak and LRA to the host
+    juce::RangedAudioParameter* peakParamObject = nullptr; // Peak meter as the host sees it
+    juce::RangedAudioParameter* lraParamObject = nullptr;  // LRA meter as the host sees it
     juce::AudioParameterBool* resetLraParamObject = nullptr;  // LRA reset trigger
     
     /** Loudness analysis engine */
     LoudnessMeter loudnessMeter;
+
+    /**
+     * Meter for the reference (sidechain) input. It rides on the main meter's
+     * queue, worker, chunking, timeline markers and LRA schedule, so both are
+     * queried on the same sample; only the K-weighting and the histogram are
+     * its own. Band analysis and the listening dose are left to the main meter.
+     */
+    LoudnessMeter referenceMeter;
+
+    /** Listening dose, fed by the analysis side and kept across measurement resets and reloads */
+    ExposureDose exposureDose;
     
-    /** Timing and state management */
+    /** Session-wide instance table, shared by every instance */
+    juce::SharedResourcePointer<SessionRegistry> sessionRegistry;
+    int sessionSlot = -1;                           // Our slot in the registry, -1 if the table was full
+
+    /** The editor's consistent view of the latest block */
+    AnalysisSnapshotPublisher analysisSnapshot;
+
+    /**
+     * Host meter output. The audio thread only raises the peak hold; a message
+     * thread timer sends quantised values, and only when they change, so the
+     * host's parameter queue sees at most METER_OUTPUT_HZ updates per meter.
+     */
+    std::atomic<float> meterPeakHold { ParameterDefaults::peak }; // Highest block peak since the last update (dBFS)
+    float lastSentPeak = ParameterDefaults::peak;                 // Message thread only
+    float lastSentLRA = ParameterDefaults::lra;                   // Message thread only
+    static constexpr int METER_OUTPUT_HZ = 10;                    // Host meter updates per second at most
+    static constexpr float METER_PEAK_STEP_DB = 0.5f;             // Peak is sent in steps of this size
+    static constexpr float METER_LRA_STEP_LU = 0.1f;              // LRA is sent in steps of this size
+    void timerCallback() override;                                // Sends changed meter values to the host
+
+    /** Shared analysis pool and the queue feeding it from the audio thread */
+    juce::SharedResourcePointer<AnalysisWorkerPool> analysisPool;
+    std::atomic<int> analysisHandle { -1 };         // Our slot in the pool, -1 = none (audio is dropped)
+    std::atomic<bool> wantsAnalysisSlot { false };  // Prepared: keep trying for a slot while the pool is full
+    juce::AbstractFifo analysisFifo { 1 };          // Single-producer/single-consumer queue indices
+    juce::AudioBuffer<float> analysisBuffer;        // Queued audio, sized in prepareToPlay
+    juce::SpinLock analysisLock;                    // Held by whichever thread runs the analysis side
+    std::atomic<bool> analysisResetPending { false }; // Meter restart requested by handleResetLRA
+    std::atomic<bool> lraEvaluationPending { false }; // A sliced LRA evaluation is still running
+    std::atomic<bool> editorShowing { false };      // Editor visible, so serve us first
+    std::atomic<int> analysisOverruns { 0 };        // Blocks dropped because the queue was full
+
+    /**
+     * Timeline-aligned mode. The audio thread queues a marker whenever the host
+     * timeline position stops following on from the previous block; markers are
+     * placed on the stream of queued samples, which keeps counting through resets.
+     */
+    struct TimelineMarker
+    {
+        juce::int64 streamPosition;                 // analysisSamplesQueued at the marked block
+        juce::int64 timelineSample;                 // Host position of that block, -1 if the host has none
+    };
+    static constexpr int TIMELINE_MARKER_CAPACITY = 256;
+    static constexpr juce::int64 UNKNOWN_TIMELINE = std::numeric_limits<juce::int64>::min();
+    juce::AbstractFifo timelineFifo { TIMELINE_MARKER_CAPACITY };
+    std::array<TimelineMarker, TIMELINE_MARKER_CAPACITY> timelineMarkers {};
+    juce::int64 analysisSamplesQueued = 0;          // Audio thread: samples ever queued since prepare
+    juce::int64 expectedTimelineSample = UNKNOWN_TIMELINE; // Audio thread: position that would follow on
+    bool transportHasPlayed = false;                // Audio thread: host transport has played since prepare
+    std::atomic<bool> timelineResyncRequested { true }; // Analysis side lost its position (reset)
+
+    /** Analysis-side state (only touched while holding analysisLock) */
+    double analysisSampleRate = 0.0;                // Rate the meter was prepared with
+    int analysisBlockSize = 0;                      // Largest chunk the meter is given (host block or slice)
+    int energyWindowLengthSamples = 0;              // One second of samples, for the energy tracker
+    juce::int64 analysisClock = 0;                  // Samples fed to the meter since prepare/reset
+    juce::int64 analysisStreamPosition = 0;         // Samples consumed (fed or dropped) since prepare
+    PeriodicSchedule lraSchedule;                   // Deadlines for LRA queries on analysisClock
+    int analysisMainChannels = 0;                   // Queued channels for the main meter (first in analysisBuffer)
+    int analysisReferenceChannels = 0;              // Queued channels for the reference meter (after them), 0 = none
+
+    /**
+     * Analysis tiers. Hidden instances with a stable verdict drop to Economy:
+     * the meter is not fed at all. A one-second energy tracker, calibrated
+     * against the short-term loudness on the way in, gives the LRA history and
+     * the listening dose an estimate for the stretch (LoudnessMeter::
+     * bridgeUnfiltered()); LRA is queried ten times less often and the queue
+     * is drained in larger batches. A 6 dB level change, an opened editor, a
+     * reset or an LRA close to a threshold promote the instance back to Full,
+     * and the estimate covers the 3 s the short-term window takes to refill.
+     * Instances comparing against a reference input stay Full.
+     */
+    enum class AnalysisTier { Full, Economy };
+    std::atomic<AnalysisTier> analysisTier { AnalysisTier::Full }; // Atomic: read by idle pool workers
+    double economyLraPeriodSamples = 0.0;           // Samples between LRA queries in Economy
+    double stableLraSeconds = 0.0;                  // Time without a reason to stay Full
+    double energyWindowSum = 0.0;                   // Sum of squares in the current energy window
+    int energyWindowSamples = 0;                    // Frames in the current energy window
+    float lastEnergyLevelDb = -100.0f;              // Level of the last completed energy window
+    float economyReferenceLevelDb = -100.0f;        // Level when we entered Economy
+    float economyLoudnessOffsetDb = 0.0f;           // Short-term LUFS minus energy level when we entered Economy
+
+    static constexpr double ECONOMY_LRA_INTERVAL_SECONDS = 10.0; // LRA query period in Economy
+    static constexpr double TIER_STABLE_SECONDS = 10.0;          // Stable time before entering Economy
+    static constexpr float TIER_THRESHOLD_MARGIN_LU = 0.5f;      // Closer than this to a threshold stays Full
+    static constexpr float TIER_PROMOTE_LEVEL_CHANGE_DB = 6.0f;  // Level change that ends Economy
+
+    /** Results published by the analysis side */
+    std::atomic<float> analysedLRA { 0.0f };        // Latest LRA from the meter
+    std::atomic<juce::uint32> lraUpdateCount { 0 }; // Bumped after each new LRA
+    std::atomic<float> provisionalLRA { 0.0f };     // LoudnessRangeEstimator, after every slice
+    std::atomic<float> provisionalHalfWidth { 0.0f };
+    std::atomic<int> provisionalValueCount { 0 };
+    std::atomic<bool> bandsAvailable { false };     // Band results below are from the running measurement
+    std::array<std::atomic<float>, MultibandLoudness::numBands> bandLRAs {};
+    std::array<std::atomic<float>, MultibandLoudness::numBands> bandShortTermLUFS {};
+    std::atomic<bool> microDynamicsAvailable { false }; // MicroDynamicsTracker, with each LRA
+    std::atomic<float> currentPSR { 0.0f }, lowestPSR { 0.0f }, currentPLR { 0.0f }, currentCrest { 0.0f }, maxPeakDb { -100.0f };
+    std::atomic<bool> referenceConnected { false }; // Reference bus enabled at the last prepare
+    ReferenceComparisonPublisher referenceComparison; // Main against reference, with each LRA (under analysisLock)
+    juce::uint32 lastSeenLraUpdate = 0;             // Audio thread's view of lraUpdateCount
+
+    /**
+     * Measurement kept with the plugin state. setStateInformation() leaves the
+     * snapshot here and asks for a meter restart; the analysis side restores it
+     * into the fresh meter and publishes its LRA, and the audio thread then
+     * takes the status straight from that LRA instead of measuring again.
+     */
+    juce::MemoryBlock pendingMeasurement;           // Snapshot waiting for the next restart (analysisLock)
+    std::atomic<bool> measurementRestored { false }; // Published LRA comes from a restored snapshot
+
+    /**
+     * Crash checkpoints. The shared writer thread copies the history out of the
+     * meter every few seconds (under a try-lock, so the analysis side never
+     * waits; prepareToPlay rebuilds the meters under the same lock) and stores
+     * it in a memory-mapped file. The file's id is saved with
+     * the state; a checkpoint newer than the loaded state is restored instead.
+     */
+    juce::SharedResourcePointer<CheckpointWriter> checkpointWriter;
+    MeasurementCheckpoint checkpoint { *checkpointWriter };
+    juce::MemoryBlock checkpointData;               // Writer thread: reused snapshot buffer
+    static constexpr const char* CHECKPOINT_ID_PROPERTY = "checkpointId"; // State properties, not parameters
+    static constexpr const char* SAVED_AT_PROPERTY = "savedAt";
+    static constexpr const char* USER_PRESET_PROPERTY = "userPresetId";
+    juce::uint32 lastCheckpointUpdate = 0;          // Writer thread: lraUpdateCount at the last checkpoint
+    bool lastCheckpointHadMeasurement = false;      // Writer thread: whether it held a measurement
+
+    static constexpr double ANALYSIS_QUEUE_SECONDS = 2.0;     // Audio the queue can hold
+    static constexpr int MAX_SAMPLES_PER_ANALYSIS_SLICE = 8192; // Work done per pool slice
+    static constexpr int LRA_BINS_PER_SLICE = 250;            // Histogram bins evaluated per slice
+
+    /**
+     * Offline render. A bounce has no deadline, only throughput: the queue is
+     * drained in large batches, the render thread waits for the pool instead of
+     * dropping audio, and no LRA is evaluated until the render finishes. The
+     * host's end-of-render call only raises a flag; the message-thread timer
+     * then drains the queue, evaluates the whole histogram in one go and
+     * writes the render report.
+     */
+    std::atomic<bool> offlineRenderActive { false }; // From setNonRealtime(true) until the render is reported
+    std::atomic<bool> renderFinishRequested { false }; // Host has ended the render; the timer finishes it
+    juce::int64 renderStartMs = 0;                  // Wall time the render started (host's calling thread)
+    std::atomic<juce::int64> renderSamples { 0 };   // Samples rendered so far (written by the audio thread)
+    std::atomic<float> renderPeakGain { 0.0f };     // Highest sample magnitude of the render (audio thread)
+    static constexpr int OFFLINE_SLICE_FACTOR = 8;  // Offline slices are this many times larger
+
+    /** Timing instrumentation (see TimingHistogram.h) */
+    TimingHistogram callbackTiming;                 // Wall time of each processBlock call
+    TimingHistogram meterTiming;                    // LoudnessMeter::processBlock, per analysed chunk
+    TimingHistogram lraQueryTiming;                 // One step of the sliced LRA evaluation
+    std::atomic<bool> timingEnabled { DYNAMICSDOCTOR_TIMING_ENABLED_BY_DEFAULT != 0 }; // Runtime switch for all three histograms
+    std::atomic<double> blockDeadlineMicros { 0.0 }; // Duration of the largest host block
+
+    /** Timing and state management (all deadlines in whole samples, see SampleClock.h) */
     double internalSampleRate = 0.0;                // Current sample rate
-    int samplesUntilLraUpdate = 0;                  // Counter for LRA update timing
-    std::atomic<int> samplesProcessedSinceReset {0}; // Samples since last LRA reset
+    SampleClock audioClock;                         // Samples seen by processBlock since prepare
+    MeasurementDeadlines deadlines;                 // Measuring window and audio timeout on the clock
+    std::atomic<juce::int64> samplesProcessedSinceReset {0}; // Samples since last LRA reset
     
     /** Analysis results - atomic for thread-safe editor access */
     std::atomic<float> currentPeak { ParameterDefaults::peak };  // Current peak level
     std::atomic<float> currentGlobalLRA { 0.0f };                // Current LRA value
     std::atomic<DynamicsStatus> currentStatus { DynamicsStatus::Measuring }; // Current state
+    std::atomic<juce::uint64> presetVerdicts { 0 };              // Packed PresetVerdicts for currentGlobalLRA
+    StatusFilter statusFilter;                                   // Hysteresis and dwell (audio thread)
+
+    /** Event journal (see EventJournal.h) */
+    EventJournal eventJournal { *presetRegistry };
+    std::atomic<juce::int64> blockStartSample { 0 };             // audioClock at the start of the current block
+    std::atomic<int> lastPresetIndex { ParameterDefaults::preset }; // For the from side of preset change events
+    std::atomic<int> userPresetIndex { -1 };                     // Table slot of a user preset chosen in the editor, or -1
     
     /** Audio state monitoring */
-    std::atomic<double> timeSinceLastAudio { 0.0 };              // Time since last audio signal
+    std::atomic<juce::int64> samplesSinceLastAudio { 0 };        // Samples since last audio signal
     std::atomic<bool> waitingForNextAudio { false };             // Flag to indicate we're waiting for next audio signal
+    std::atomic<bool> transportPaused { false };                 // Host transport stopped, measurement frozen
     std::atomic<bool> isInitialMeasuringPhase { true };  // Flag to track initial measuring phase
-    static constexpr double LRA_MEASURING_DURATION_SECONDS = 15.0;    // Duration for LRA measurement (15 seconds)
-    static constexpr double AUDIO_TIMEOUT = 300.0;                    // 5 minutes timeout for no audio
     
     /** Internal processing methods */
     void handleResetLRA();                         // Reset LRA measurement
-    void updateStatusBasedOnLRA(float measuredLRA); // Update status based on LRA thresholds
+    void setStatus(DynamicsStatus newStatus);      // Store the status, journalling a transition
+    void updateStatusBasedOnLRA(float measuredLRA); // Judge all presets, then take the selected one's status
+    void applySelectedPresetVerdict();             // Show the stored verdict of a newly selected preset
+    void applyPublishedLRA();                      // Take up a new LRA from the analysis side (audio thread)
+    void joinAnalysisPool();                       // Register with the pool (message thread)
+    void leaveAnalysisPool();                      // Unregister; returns once no worker is inside us
+    void publishBlockResults();                    // Snapshot for the editor and session overview (audio thread)
+    void publishAnalysisSnapshot();                // Snapshot after a change made off the audio thread
+    AnalysisSnapshot makeAnalysisSnapshot() const; // Current peak, LRA, status and flags
+    void beginOfflineRender();                     // Enter throughput mode
+    void requestOfflineRenderFinish() noexcept;    // Flag the end of a render (any thread)
+    void finishOfflineRender();                    // Final full evaluation and render report (message thread)
+    void pushToAnalysis(const juce::AudioBuffer<float>& buffer, juce::int64 timelineSample); // Queue a block for the analysis side
+    juce::int64 applyTimelineMarkers();                         // Pass due markers to the meter; samples to the next one
+    bool isTimelineAligned() const;                             // Timeline-aligned mode switched on
+    bool isBandAnalysisEnabled() const;                         // Band analysis switched on
+    void configureMeter();                                      // Apply the meter options before prepare (analysis side)
+    void analyseQueuedRange(int startSample, int numSamples);   // Meter a contiguous run of the queue
+    void continueLraEvaluation(int maxBins);                    // Advance the sliced LRA evaluation
+    void publishLRA(float lra);                                 // Hand a finished LRA to the audio thread
+    void restorePendingMeasurement();                           // Put a loaded snapshot into the fresh meter
+    void setAnalysisTier(AnalysisTier newTier);                 // Switch tier (analysis side)
+    void updateAnalysisTier(float lra);                         // Re-evaluate the tier after an LRA query
+    void trackEconomyEnergy(const juce::AudioBuffer<float>& block); // Cheap level tracker for promotion
+    double getLraPeriodSamples() const;                         // Samples between LRA queries (rate and tier)
+    void restartLraSchedule(juce::int64 firstDeadline);        // New query series at the current period
+    juce::int64 getStaggeredLraDelay() const;                   // First query offset, spread across instances
+    void presetSelectionChanged();                              // Journal the change and show the new preset's verdict
+    const DynamicsPreset& getSelectedPreset() const;            // Selected preset; off the message thread, inside a ReadScope
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DynamicsDoctorProcessor)
@@ -0,0 +1,68 @@
+#include "PluginState.h"
+
+namespace
+{
+    constexpr int stateMagic = 0x74734444;                  // "DDst"
+    constexpr int parametersSection = 0x4d524150;           // "PARM"
+    constexpr int measurementSection = 0x5341454d;          // "MEAS"
+
+    void writeSection (juce::OutputStream& output, int id, const void* data, size_t size)
+    {
+        output.writeInt(id);
+        output.writeInt(static_cast<int>(size));
+        output.write(data, size);
+    }
+}
+
+//==============================================================================
+void PluginState::write (const juce::ValueTree& parameters, const juce::MemoryBlock& measurement, juce::MemoryBlock& destData)
+{
+    juce::MemoryOutputStream output (destData, false);
+    output.writeInt(stateMagic);
+    output.writeInt(formatVersion);
+
+    juce::MemoryOutputStream parameterData;
+    parameters.writeToStream(parameterData);
+    writeSection(output, parametersSection, parameterData.getData(), parameterData.getDataSize());
+
+    if (! measurement.isEmpty())
+        writeSection(output, measurementSection, measurement.getData(), measurement.getSize());
+}
+
+bool PluginState::read (const void* data, int sizeInBytes, juce::ValueTree& parameters, juce::MemoryBlock& measurement)
+{
+    if (data == nullptr || sizeInBytes < 8)
+        return false;
+
+    juce::MemoryInputStream input (data, static_cast<size_t>(sizeInBytes), false);
+    if (input.readInt() != stateMagic)
+        return false;
+
+    const int version = input.readInt();
+    if (version > formatVersion)
+        DBG("PluginState: Format version " << version << " is newer than this build's; unknown sections are skipped.");
+
+    parameters = juce::ValueTree();
+    measurement.reset();
+
+    while (input.getNumBytesRemaining() >= 8)
+    {
+        const int id = input.readInt();
+        const int size = input.readInt();
+        if (size < 0 || size > input.getNumBytesRemaining())
+        {
+            DBG("PluginState: Section " << id << " runs past the end of the data; ignoring the rest.");
+            break;
+        }
+
+        const auto* sectionData = static_cast<const char*>(data) + input.getPosition();
+        if (id == parametersSection)
+            parameters = juce::ValueTree::readFromData(sectionData, static_cast<size_t>(size));
+        else if (id == measurementSection)
+            measurement.replaceAll(sectionData, static_cast<size_t>(size));
+
+        input.setPosition(input.getPosition() + size);
+    }
+
+    return parameters.isValid();
+}
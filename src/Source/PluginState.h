@@ -0,0 +1,32 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+//==============================================================================
+/**
+ * Binary layout of the plugin state, as handed to the host.
+ *
+ *   magic "DDst", format version            (two int32)
+ *   sections, each: id, size, data          (int32, int32, bytes)
+ *     "PARM"  parameters and settings, as a binary ValueTree
+ *     "MEAS"  measurement history (LoudnessMeter::writeSnapshot()), optional
+ *
+ * Readers skip sections they don't know, so a later version can add sections
+ * and older builds still load its parameters. Nothing is parsed as text, which
+ * keeps the host's periodic autosave cheap. State saved as XML by earlier
+ * builds is recognised by its own magic number and read by the processor.
+ */
+namespace PluginState
+{
+    constexpr int formatVersion = 1;
+
+    /** Writes the parameters and, unless it is empty, a measurement snapshot. */
+    void write (const juce::ValueTree& parameters, const juce::MemoryBlock& measurement, juce::MemoryBlock& destData);
+
+    /**
+     * Reads a state written by write(). Returns false if the data is not in
+     * this format or has no parameters; measurement is empty if none was saved.
+     */
+    bool read (const void* data, int sizeInBytes, juce::ValueTree& parameters, juce::MemoryBlock& measurement);
+}
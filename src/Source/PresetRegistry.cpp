@@ -0,0 +1,388 @@
+#include "PresetRegistry.h"
+#include <cmath>     // For std::isfinite
+#include <algorithm> // For std::find_if
+
+//==============================================================================
+int PresetRegistry::Table::getValidIndex (int index) const noexcept
+{
+    const int numPresets = static_cast<int>(presets.size());
+    if (juce::isPositiveAndBelow(index, numPresets))
+        return index;
+
+    return juce::isPositiveAndBelow(ParameterDefaults::preset, numPresets) ? ParameterDefaults::preset : 0;
+}
+
+int PresetRegistry::Table::findPreset (const std::string& id) const noexcept
+{
+    for (size_t i = 0; i < presets.size(); ++i)
+        if (presets[i].id == id)
+            return static_cast<int>(i);
+
+    return -1;
+}
+
+//==============================================================================
+PresetRegistry::PresetRegistry()
+{
+    reload();
+    startTimer(pollIntervalMs);
+}
+
+PresetRegistry::~PresetRegistry()
+{
+    stopTimer();
+    currentTable.store(nullptr);
+}
+
+juce::File PresetRegistry::getUserPresetFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("DynamicsDoctor")
+               .getChildFile("Presets.json");
+}
+
+//==============================================================================
+void PresetRegistry::reload()
+{
+    std::vector<DynamicsPreset> newPresets (builtInPresets.begin(), builtInPresets.end());
+    juce::StringArray report;
+
+    const auto file = getUserPresetFile();
+    fileExisted = file.existsAsFile();
+    lastFileModification = fileExisted ? file.getLastModificationTime() : juce::Time();
+
+    if (fileExisted)
+    {
+        juce::var json;
+        const auto result = juce::JSON::parse(file.loadFileAsString(), json);
+
+        if (result.failed())
+        {
+            // Most likely a save in the middle of an edit: keep what we have
+            lastLoadReport = juce::StringArray("Presets.json: " + result.getErrorMessage());
+            DBG("PresetRegistry: Could not parse " << file.getFullPathName() << " - " << result.getErrorMessage());
+
+            if (ownedTable != nullptr)
+                return;
+        }
+        else
+        {
+            loadUserPresets(json, newPresets, report);
+            lastLoadReport = report;
+        }
+    }
+    else
+    {
+        lastLoadReport.clear();
+    }
+
+    publish(std::move(newPresets));
+
+    for (const auto& line : lastLoadReport)
+        DBG("PresetRegistry: " << line);
+}
+
+void PresetRegistry::loadUserPresets (const juce::var& json, std::vector<DynamicsPreset>& presets, juce::StringArray& report)
+{
+    const auto* entries = json["presets"].getArray();
+    if (entries == nullptr)
+    {
+        report.add("Presets.json: expected a \"presets\" array");
+        return;
+    }
+
+    juce::StringArray userIds;
+    int entryNumber = 0;
+
+    for (const auto& entry : *entries)
+    {
+        const juce::String where = "Preset " + juce::String(++entryNumber);
+
+        if (! entry.isObject())
+        {
+            report.add(where + ": not an object");
+            continue;
+        }
+
+        DynamicsPreset preset;
+        const auto id = entry["id"].toString().trim();
+        preset.id = id.toStdString();
+        preset.label = entry["label"].toString().trim();
+        if (preset.label.isEmpty())
+            preset.label = id;
+
+        auto readThreshold = [&] (const char* name, float& destination)
+        {
+            const auto& value = entry[name];
+            if (! (value.isDouble() || value.isInt() || value.isInt64()))
+            {
+                report.add(where + ": \"" + name + "\" is missing or not a number");
+                return false;
+            }
+
+            destination = static_cast<float>(static_cast<double>(value));
+            if (! std::isfinite(destination) || destination < 0.0f || destination > maxThresholdLU)
+            {
+                report.add(where + ": \"" + name + "\" must be between 0 and " + juce::String(maxThresholdLU) + " LU");
+                return false;
+            }
+            return true;
+        };
+
+        // Optional fields keep the DynamicsPreset default when absent
+        auto readOptional = [&] (const char* name, double maximum, double& destination)
+        {
+            const auto& value = entry[name];
+            if (value.isVoid())
+                return true;
+
+            const double number = (value.isDouble() || value.isInt() || value.isInt64()) ? static_cast<double>(value) : -1.0;
+            if (! std::isfinite(number) || number < 0.0 || number > maximum)
+            {
+                report.add(where + ": \"" + name + "\" must be a number between 0 and " + juce::String(maximum));
+                return false;
+            }
+
+            destination = number;
+            return true;
+        };
+
+        if (id.isEmpty())
+        {
+            report.add(where + ": \"id\" is missing");
+            continue;
+        }
+
+        if (preset.label.length() > maxLabelLength)
+        {
+            report.add(where + " (" + id + "): label is longer than " + juce::String(maxLabelLength) + " characters");
+            continue;
+        }
+
+        if (! (readThreshold("lraThresholdRed", preset.lraThresholdRed)
+               && readThreshold("lraThresholdAmber", preset.lraThresholdAmber)
+               && readThreshold("targetLraMin", preset.targetLraMin)
+               && readThreshold("targetLraMax", preset.targetLraMax)))
+        {
+            continue;
+        }
+
+        double hysteresis = preset.hysteresisLU, minPSR = preset.minPSR, minPLR = preset.minPLR;
+        if (! (readOptional("hysteresisLU", maxHysteresisLU, hysteresis)
+               && readOptional("minDwellSeconds", maxDwellSeconds, preset.minDwellSeconds)
+               && readOptional("minPSR", maxRatioDb, minPSR)
+               && readOptional("minPLR", maxRatioDb, minPLR)))
+        {
+            continue;
+        }
+        preset.hysteresisLU = static_cast<float>(hysteresis);
+        preset.minPSR = static_cast<float>(minPSR);
+        preset.minPLR = static_cast<float>(minPLR);
+
+        if (preset.lraThresholdRed > preset.lraThresholdAmber)
+        {
+            report.add(where + " (" + id + "): lraThresholdRed is above lraThresholdAmber");
+            continue;
+        }
+
+        if (preset.targetLraMin > preset.targetLraMax)
+        {
+            report.add(where + " (" + id + "): targetLraMin is above targetLraMax");
+            continue;
+        }
+
+        if (userIds.contains(id))
+        {
+            report.add(where + " (" + id + "): duplicate id, skipped");
+            continue;
+        }
+        userIds.add(id);
+
+        // Same id as a built-in: replace it in place so indices stay stable
+        auto existing = std::find_if(presets.begin(), presets.end(),
+                                     [&preset] (const DynamicsPreset& p) { return p.id == preset.id; });
+        if (existing != presets.end())
+        {
+            *existing = preset;
+            continue;
+        }
+
+        presets.push_back(preset);
+    }
+}
+
+//==============================================================================
+void PresetRegistry::publish (std::vector<DynamicsPreset> loadedPresets)
+{
+    const auto firstUserPreset = loadedPresets.begin() + static_cast<std::ptrdiff_t>(builtInPresets.size());
+    jassert(loadedPresets.size() >= builtInPresets.size());
+
+    auto table = std::make_unique<Table>();
+    table->presets.assign(loadedPresets.begin(), firstUserPreset);
+    table->listed.assign(table->presets.size(), true);
+    table->generation = (ownedTable != nullptr) ? ownedTable->generation + 1 : 1;
+
+    // User presets stay in the slot they were first loaded into, so that
+    // selections and verdicts follow them; one gone from the file stays unlisted
+    if (ownedTable != nullptr)
+    {
+        for (size_t i = builtInPresets.size(); i < ownedTable->presets.size(); ++i)
+        {
+            const auto& previous = ownedTable->presets[i];
+            const auto loaded = std::find_if(firstUserPreset, loadedPresets.end(),
+                                             [&previous] (const DynamicsPreset& p) { return p.id == previous.id; });
+            const bool isListed = loaded != loadedPresets.end();
+            table->presets.push_back(isListed ? *loaded : previous);
+            table->listed.push_back(isListed);
+        }
+    }
+
+    for (auto preset = firstUserPreset; preset != loadedPresets.end(); ++preset)
+    {
+        if (table->findPreset(preset->id) >= 0)
+            continue;
+
+        if (static_cast<int>(table->presets.size()) >= maxPresets)
+        {
+            lastLoadReport.add(juce::String(preset->id) + ": more than " + juce::String(maxPresets)
+                               + " presets since the host started, skipped");
+            continue;
+        }
+
+        table->presets.push_back(*preset);
+        table->listed.push_back(true);
+    }
+
+    // Readers may still hold the old table until their ReadScope ends
+    if (ownedTable != nullptr)
+        retiredTables.push_back(std::move(ownedTable));
+
+    ownedTable = std::move(table);
+    currentTable.store(ownedTable.get(), std::memory_order_release);
+}
+
+std::atomic<int>& PresetRegistry::enterRead() const noexcept
+{
+    // Only counted once the epoch is seen not to have moved on meanwhile, so a
+    // reader always sits in the counter that freeRetiredTables() waits on
+    for (;;)
+    {
+        const auto epoch = readEpoch.load();
+        auto& readers = readersInEpoch[epoch & 1];
+        readers.fetch_add(1);
+
+        if (readEpoch.load() == epoch)
+            return readers;
+
+        readers.fetch_sub(1);
+    }
+}
+
+void PresetRegistry::freeRetiredTables()
+{
+    // Readers that entered before the current epoch may still hold a table
+    // retired before it began. Once they are gone those tables can go, and the
+    // epoch moves on for the tables retired since.
+    if (readersInEpoch[(readEpoch.load() - 1) & 1].load() != 0)
+        return;
+
+    drainingTables.clear();
+
+    if (! retiredTables.empty())
+    {
+        drainingTables = std::move(retiredTables);
+        retiredTables.clear();
+        readEpoch.fetch_add(1);
+    }
+}
+
+void PresetRegistry::timerCallback()
+{
+    freeRetiredTables();
+
+    const auto file = getUserPresetFile();
+    const bool exists = file.existsAsFile();
+    if (exists != fileExisted || (exists && file.getLastModificationTime() != lastFileModification))
+    {
+        DBG("PresetRegistry: " << file.getFullPathName() << " changed, reloading.");
+        reload();
+    }
+}
+
+//==============================================================================
+juce::String PresetRegistry::getLabel (int index) const
+{
+    const ReadScope readScope (*this);
+    const auto& table = getTable();
+    if (juce::isPositiveAndBelow(index, static_cast<int>(table.presets.size())))
+        return table.presets[static_cast<size_t>(index)].label;
+
+    return "(unknown)";
+}
+
+juce::String PresetRegistry::getLastLoadReport() const
+{
+    return lastLoadReport.joinIntoString("\n");
+}
+
+//==============================================================================
+PresetVerdicts PresetVerdicts::evaluate (const PresetRegistry::Table& table, float measuredLRA) noexcept
+{
+    juce::uint64 packed = 0;
+    const int numPresets = juce::jmin(static_cast<int>(table.presets.size()), PresetRegistry::maxPresets);
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        const auto& preset = table.presets[static_cast<size_t>(i)];
+        juce::uint64 field = toField(judge(preset, measuredLRA));
+
+        if (measuredLRA < preset.targetLraMin)
+            field |= belowTargetBit;
+        else if (measuredLRA > preset.targetLraMax)
+            field |= aboveTargetBit;
+
+        packed |= field << (i * bitsPerPreset);
+    }
+
+    return PresetVerdicts(packed);
+}
+
+DynamicsStatus PresetVerdicts::judge (const DynamicsPreset& preset, float measuredLRA) noexcept
+{
+    if (measuredLRA < preset.lraThresholdRed)
+        return DynamicsStatus::Loss;
+    if (measuredLRA < preset.lraThresholdAmber)
+        return DynamicsStatus::Reduced;
+    return DynamicsStatus::Ok;
+}
+
+PresetVerdicts PresetVerdicts::withStatus (int index, DynamicsStatus status) const noexcept
+{
+    if (! juce::isPositiveAndBelow(index, PresetRegistry::maxPresets))
+        return *this;
+
+    const int shift = index * bitsPerPreset;
+    return PresetVerdicts((packed & ~(statusMask << shift)) | (toField(status) << shift));
+}
+
+juce::uint64 PresetVerdicts::toField (DynamicsStatus status) noexcept
+{
+    switch (status)
+    {
+        case DynamicsStatus::Ok:      return 1;
+        case DynamicsStatus::Reduced: return 2;
+        case DynamicsStatus::Loss:    return 3;
+        default:                      return 0;
+    }
+}
+
+DynamicsStatus PresetVerdicts::getStatus (int index) const noexcept
+{
+    switch (getField(index) & statusMask)
+    {
+        case 1:  return DynamicsStatus::Ok;
+        case 2:  return DynamicsStatus::Reduced;
+        case 3:  return DynamicsStatus::Loss;
+        default: return DynamicsStatus::Measuring;
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Constants.h" // For DynamicsPreset, builtInPresets
+
+//==============================================================================
+/**
+ * Process-wide list of presets: the built-in ones followed by user presets
+ * loaded from a JSON file, so house presets per client or delivery spec can be
+ * added without recompiling.
+ *
+ * The file lives at <user application data>/DynamicsDoctor/Presets.json:
+ *
+ *     { "presets": [ { "id": "client_tv", "label": "Client TV",
+ *                      "lraThresholdRed": 5.0, "lraThresholdAmber": 6.0,
+ *                      "targetLraMin": 6.0, "targetLraMax": 15.0,
+ *                      "hysteresisLU": 0.3, "minDwellSeconds": 5,
+ *                      "minPSR": 6.0, "minPLR": 8.0 } ] }
+ *
+ * hysteresisLU, minDwellSeconds, minPSR and minPLR are optional and default
+ * to the DynamicsPreset defaults.
+ *
+ * Entries are validated one by one; a bad entry is skipped and reported, a
+ * user preset whose id matches a built-in one replaces it in place. Built-ins
+ * keep their indices, so saved sessions still point at the same preset. A user
+ * preset keeps the slot it was first loaded into for the life of the process;
+ * one that is removed from the file stays in its slot, unlisted.
+ *
+ * The file is polled for changes and reloaded on the message thread. Each load
+ * produces a new immutable table that is swapped in with one atomic store, so
+ * the audio and analysis threads read thresholds without locking. They do so
+ * inside a ReadScope, and a replaced table is only freed once every scope that
+ * could still see it has ended. Swapping a table never touches the preset
+ * parameter, so running measurements go on.
+ *
+ * Shared between instances through juce::SharedResourcePointer.
+ */
+class PresetRegistry : private juce::Timer
+{
+public:
+    static constexpr int maxPresets = 16;           // Slots per process, built-in and user (see PresetVerdicts)
+    static constexpr int maxLabelLength = 40;       // Characters
+    static constexpr float maxThresholdLU = 40.0f;  // Upper bound for any LRA value in a preset
+    static constexpr float maxHysteresisLU = 5.0f;  // Upper bound for hysteresisLU
+    static constexpr double maxDwellSeconds = 600.0; // Upper bound for minDwellSeconds
+    static constexpr double maxRatioDb = 30.0;      // Upper bound for minPSR and minPLR
+    static constexpr int pollIntervalMs = 2000;     // File change check and freeing of replaced tables
+
+    /** An immutable snapshot of all presets. */
+    struct Table
+    {
+        std::vector<DynamicsPreset> presets;        // Never empty; at most maxPresets entries
+        std::vector<bool> listed;                   // Per preset; false once a user preset left the file
+        juce::uint32 generation = 0;                // Increases with every reload
+
+        /** The index itself, or the default preset's index if it is out of range. */
+        int getValidIndex (int index) const noexcept;
+
+        /** Index of the preset with an id, or -1. */
+        int findPreset (const std::string& id) const noexcept;
+
+        /** True if the preset at index is built in or still in the user preset file. */
+        bool isListed (int index) const noexcept
+        {
+            return juce::isPositiveAndBelow(index, static_cast<int>(listed.size())) && listed[static_cast<size_t>(index)];
+        }
+
+        /** Preset at an index, or the default preset if the index is out of range. */
+        const DynamicsPreset& getPreset (int index) const noexcept { return presets[static_cast<size_t>(getValidIndex(index))]; }
+    };
+
+    /**
+     * Held by a thread other than the message thread for as long as it uses a
+     * table, or a preset reference taken from one. Lock-free; a reload that
+     * happens meanwhile leaves the table alone until the scope has ended.
+     */
+    class ReadScope
+    {
+    public:
+        explicit ReadScope (const PresetRegistry& registry) noexcept : readers (registry.enterRead()) {}
+        ~ReadScope() noexcept { readers.fetch_sub(1); }
+
+    private:
+        std::atomic<int>& readers;
+
+        JUCE_DECLARE_NON_COPYABLE (ReadScope)
+    };
+
+    PresetRegistry();
+    ~PresetRegistry() override;
+
+    /**
+     * Current table. Lock-free. Tables are freed on the message thread, so it
+     * needs no ReadScope; every other thread must hold one while using the table.
+     */
+    const Table& getTable() const noexcept { return *currentTable.load(std::memory_order_acquire); }
+
+    /** Label for a preset index (used by the preset parameter's text). Any thread. */
+    juce::String getLabel (int index) const;
+
+    /** Reloads the file now. Call from the message thread. */
+    void reload();
+
+    /** The user preset file (may not exist). */
+    static juce::File getUserPresetFile();
+
+    /** Problems found by the last load, one per line; empty if none. Message thread only. */
+    juce::String getLastLoadReport() const;
+
+private:
+    void timerCallback() override;
+    void publish (std::vector<DynamicsPreset> loadedPresets);
+    void freeRetiredTables();                                   // Message thread
+
+    /** Counts a reader in the current epoch and returns its counter. */
+    std::atomic<int>& enterRead() const noexcept;
+
+    /** Validates and appends the entries of a parsed file, collecting problems in report. */
+    static void loadUserPresets (const juce::var& json, std::vector<DynamicsPreset>& presets, juce::StringArray& report);
+
+    std::atomic<const Table*> currentTable { nullptr };
+    std::unique_ptr<Table> ownedTable;                          // The table currentTable points to
+
+    // Replaced tables wait in retiredTables until the reader epoch can be moved
+    // on, then in drainingTables until no reader from before that is left
+    std::vector<std::unique_ptr<Table>> retiredTables;
+    std::vector<std::unique_ptr<Table>> drainingTables;
+    mutable std::atomic<juce::uint32> readEpoch { 0 };
+    mutable std::array<std::atomic<int>, 2> readersInEpoch {};  // Open ReadScopes by epoch parity
+
+    juce::Time lastFileModification;
+    bool fileExisted = false;
+    juce::StringArray lastLoadReport;                           // Message thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetRegistry)
+};
+
+//==============================================================================
+/**
+ * The verdict of every preset in a table for one measured LRA, packed into a
+ * single 64-bit word (4 bits per preset) so it can be published atomically.
+ *
+ * The LRA measurement itself doesn't depend on the preset, so all presets are
+ * judged at once and switching presets just reads another field.
+ *
+ * Per preset: bits 0-1 hold the status (0 = no verdict, 1 = Ok, 2 = Reduced,
+ * 3 = Loss), bit 2 is set below targetLraMin and bit 3 above targetLraMax.
+ */
+class PresetVerdicts
+{
+public:
+    static constexpr int bitsPerPreset = 4;
+    static_assert(PresetRegistry::maxPresets * bitsPerPreset <= 64, "Verdicts must fit in one word");
+
+    PresetVerdicts() = default;
+    explicit PresetVerdicts (juce::uint64 packedVerdicts) noexcept : packed (packedVerdicts) {}
+
+    /** Judges every preset of a table against one LRA. Lock-free and allocation-free. */
+    static PresetVerdicts evaluate (const PresetRegistry::Table& table, float measuredLRA) noexcept;
+
+    /** Ok, Reduced or Loss for one preset and LRA (no hysteresis). */
+    static DynamicsStatus judge (const DynamicsPreset& preset, float measuredLRA) noexcept;
+
+    /** Copy with the status of one preset replaced (Ok, Reduced or Loss); target flags are kept. */
+    PresetVerdicts withStatus (int index, DynamicsStatus status) const noexcept;
+
+    /** True if the preset at index has a verdict. */
+    bool hasVerdict (int index) const noexcept      { return getField(index) & statusMask; }
+
+    /** Ok, Reduced or Loss; Measuring if there is no verdict for the index. */
+    DynamicsStatus getStatus (int index) const noexcept;
+
+    bool isBelowTarget (int index) const noexcept   { return getField(index) & belowTargetBit; }
+    bool isAboveTarget (int index) const noexcept   { return getField(index) & aboveTargetBit; }
+
+    juce::uint64 getPacked() const noexcept         { return packed; }
+
+private:
+    static constexpr juce::uint64 statusMask = 0x3, belowTargetBit = 0x4, aboveTargetBit = 0x8;
+
+    static juce::uint64 toField (DynamicsStatus status) noexcept;
+
+    juce::uint64 getField (int index) const noexcept
+    {
+        if (! juce::isPositiveAndBelow(index, PresetRegistry::maxPresets))
+            return 0;
+        return (packed >> (index * bitsPerPreset)) & 0xf;
+    }
+
+    juce::uint64 packed = 0;
+};
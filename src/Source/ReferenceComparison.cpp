@@ -0,0 +1,60 @@
+#include "ReferenceComparison.h"
+
+namespace
+{
+    constexpr int maxSeqlockReadAttempts = 64; // Published once per LRA query, so a retry is rare
+}
+
+//==============================================================================
+juce::String ReferenceComparison::describe() const
+{
+    if (! isAvailable)
+        return "Reference: waiting for a full short-term window on both inputs";
+
+    juce::String text;
+    text << "LRA: " << juce::String(referenceLRA, 1) << " LU reference, " << juce::String(lra, 1)
+         << " LU main, " << juce::String(getLraRemoved(), 1) << " LU removed\n"
+         << "PLR: " << juce::String(referencePLR, 1) << " dB reference, " << juce::String(plr, 1)
+         << " dB main, " << juce::String(getPlrRemoved(), 1) << " dB removed";
+    return text;
+}
+
+//==============================================================================
+void ReferenceComparisonPublisher::publish (const ReferenceComparison& comparison) noexcept
+{
+    // Seqlock write: odd sequence means an update is in progress.
+    sequence.fetch_add(1, std::memory_order_acq_rel);
+    isAvailable.store(comparison.isAvailable, std::memory_order_relaxed);
+    lra.store(comparison.lra, std::memory_order_relaxed);
+    referenceLRA.store(comparison.referenceLRA, std::memory_order_relaxed);
+    plr.store(comparison.plr, std::memory_order_relaxed);
+    referencePLR.store(comparison.referencePLR, std::memory_order_relaxed);
+    sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool ReferenceComparisonPublisher::read (ReferenceComparison& result) const noexcept
+{
+    // Seqlock read: retry until we see the same even sequence before and after.
+    for (int attempt = 0; attempt < maxSeqlockReadAttempts; ++attempt)
+    {
+        const auto before = sequence.load(std::memory_order_acquire);
+        if ((before & 1u) != 0)
+            continue;
+
+        ReferenceComparison copy;
+        copy.isAvailable = isAvailable.load(std::memory_order_relaxed);
+        copy.lra = lra.load(std::memory_order_relaxed);
+        copy.referenceLRA = referenceLRA.load(std::memory_order_relaxed);
+        copy.plr = plr.load(std::memory_order_relaxed);
+        copy.referencePLR = referencePLR.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before)
+        {
+            result = copy;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+//==============================================================================
+/**
+ * The main input measured against the reference (sidechain) input, usually
+ * the master against the unmastered mix: how much loudness range and
+ * peak-to-loudness ratio the chain in between has taken away.
+ *
+ * Both sides come from the same LRA query, so the two measurements always
+ * cover the same stretch of audio.
+ */
+struct ReferenceComparison
+{
+    bool isAvailable = false;           // Reference connected and a full short-term window measured on both sides
+    float lra = 0.0f;                   // Main input LRA in LU
+    float referenceLRA = 0.0f;          // Reference input LRA in LU
+    float plr = 0.0f;                   // Main input PLR in dB
+    float referencePLR = 0.0f;          // Reference input PLR in dB
+
+    /** Loudness range the chain removed, in LU; negative if it added range. */
+    float getLraRemoved() const noexcept { return referenceLRA - lra; }
+
+    /** Peak-to-loudness ratio the chain removed, in dB; negative if it added headroom. */
+    float getPlrRemoved() const noexcept { return referencePLR - plr; }
+
+    /** One line each for LRA and PLR: reference, main and the difference. */
+    juce::String describe() const;
+};
+
+//==============================================================================
+/**
+ * Hands ReferenceComparisons from the analysis side to the editor with a
+ * seqlock (see AnalysisSnapshotPublisher), so the main and reference values
+ * read together always come from the same LRA query.
+ *
+ * There is a single writer at a time: the processor only publishes while it
+ * holds its analysis lock. Readers never block it.
+ */
+class ReferenceComparisonPublisher
+{
+public:
+    /** Publishes a comparison. Wait-free and allocation-free. */
+    void publish (const ReferenceComparison& comparison) noexcept;
+
+    /**
+     * Copies the latest comparison.
+     * @return False, leaving the result untouched, if a consistent copy could
+     *         not be taken (the writer kept racing the reader)
+     */
+    bool read (ReferenceComparison& result) const noexcept;
+
+private:
+    std::atomic<juce::uint32> sequence { 0 };               // Seqlock guarding the fields below
+    std::atomic<bool> isAvailable { false };
+    std::atomic<float> lra { 0.0f }, referenceLRA { 0.0f };
+    std::atomic<float> plr { 0.0f }, referencePLR { 0.0f };
+};
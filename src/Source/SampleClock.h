@@ -0,0 +1,95 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cmath> // For std::llround
+
+//==============================================================================
+/**
+ * 64-bit count of samples since a reset, with conversions from seconds.
+ *
+ * All state-machine timing is done in whole samples on this clock rather than
+ * by accumulating block durations in floating point, so deadlines are exact
+ * at every sample rate and a session can run for years without overflow.
+ */
+class SampleClock
+{
+public:
+    /** Sets the rate used by toSamples() and restarts the count. */
+    void prepare (double newSampleRate) noexcept
+    {
+        jassert(newSampleRate > 0.0);
+        sampleRate = newSampleRate;
+        now = 0;
+    }
+
+    void reset() noexcept                          { now = 0; }
+    void advance (int numSamples) noexcept         { now += numSamples; }
+    juce::int64 getNow() const noexcept            { return now; }
+    double getSampleRate() const noexcept          { return sampleRate; }
+
+    /** Duration in samples, rounded to the nearest sample (exact for integer rates and whole milliseconds). */
+    juce::int64 toSamples (double seconds) const noexcept
+    {
+        return static_cast<juce::int64>(std::llround(seconds * sampleRate));
+    }
+
+private:
+    double sampleRate = 0.0;
+    juce::int64 now = 0;
+};
+
+//==============================================================================
+/**
+ * The state machine's fixed durations in samples, converted once per
+ * prepareToPlay on the processor's clock.
+ */
+struct MeasurementDeadlines
+{
+    static constexpr double measuringSeconds = 15.0;       // Wait before the first LRA verdict
+    static constexpr double audioTimeoutSeconds = 300.0;   // Silence before falling back to AwaitingAudio
+
+    juce::int64 measuringDuration = 0;
+    juce::int64 audioTimeout = 0;
+
+    void prepare (const SampleClock& clock) noexcept
+    {
+        measuringDuration = clock.toSamples(measuringSeconds);
+        audioTimeout = clock.toSamples(audioTimeoutSeconds);
+    }
+};
+
+//==============================================================================
+/**
+ * A series of deadlines with a possibly fractional period (e.g. 11025 Hz at
+ * 10 Hz is 1102.5 samples). Each deadline is computed from the origin rather
+ * than from the previous one, so rounding never accumulates into drift.
+ */
+class PeriodicSchedule
+{
+public:
+    /** Starts a new series whose first deadline is firstDeadline. */
+    void start (juce::int64 firstDeadline, double newPeriodSamples) noexcept
+    {
+        jassert(newPeriodSamples >= 1.0);
+        origin = firstDeadline;
+        periodSamples = juce::jmax(1.0, newPeriodSamples);
+        index = 0;
+        nextDeadline = origin;
+    }
+
+    /** Moves to the next deadline of the series. */
+    void advance() noexcept
+    {
+        ++index;
+        nextDeadline = origin + static_cast<juce::int64>(std::llround(static_cast<double>(index) * periodSamples));
+    }
+
+    juce::int64 getNextDeadline() const noexcept   { return nextDeadline; }
+    double getPeriodSamples() const noexcept       { return periodSamples; }
+
+private:
+    juce::int64 origin = 0;
+    double periodSamples = 1.0;
+    juce::int64 index = 0;
+    juce::int64 nextDeadline = 0;
+};
@@ -0,0 +1,103 @@
+#include "SessionOverviewComponent.h"
+
+namespace
+{
+    /** Sort key: the more dynamics are lost, the higher the row. */
+    int getSeverityRank (DynamicsStatus status)
+    {
+        switch (status)
+        {
+            case DynamicsStatus::Loss:          return 0;
+            case DynamicsStatus::Reduced:       return 1;
+            case DynamicsStatus::Ok:            return 2;
+            case DynamicsStatus::Measuring:     return 3;
+            case DynamicsStatus::AwaitingAudio: return 4;
+            case DynamicsStatus::Bypassed:      /* fallthrough */
+            default:                            return 5;
+        }
+    }
+
+    struct SeverityComparator
+    {
+        int compareElements (const SessionRegistry::SlotSnapshot& a, const SessionRegistry::SlotSnapshot& b) const
+        {
+            const int rankA = getSeverityRank(a.status);
+            const int rankB = getSeverityRank(b.status);
+            if (rankA != rankB)
+                return rankA < rankB ? -1 : 1;
+
+            // Within a state, the smallest LRA is the most squashed
+            if (a.lra != b.lra)
+                return a.lra < b.lra ? -1 : 1;
+
+            return a.slotIndex - b.slotIndex;
+        }
+    };
+}
+
+//==============================================================================
+SessionOverviewComponent::SessionOverviewComponent (SessionRegistry& r)
+    : registry (r)
+{
+    setInterceptsMouseClicks(false, false);
+    timerCallback();
+    startTimerHz(10);
+}
+
+SessionOverviewComponent::~SessionOverviewComponent()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void SessionOverviewComponent::timerCallback()
+{
+    registry.collectSnapshots(rows);
+
+    SeverityComparator comparator;
+    rows.sort(comparator, true);
+
+    // Header row plus one row per instance
+    const int requiredHeight = rowHeight * (rows.size() + 1);
+    if (getHeight() != requiredHeight)
+        setSize(getWidth(), requiredHeight);
+
+    repaint();
+}
+
+void SessionOverviewComponent::paint (juce::Graphics& g)
+{
+    g.fillAll(Palette::Background);
+
+    auto bounds = getLocalBounds();
+    g.setFont(juce::FontOptions(11.0f));
+
+    // Header
+    auto header = bounds.removeFromTop(rowHeight);
+    g.setColour(Palette::Foreground.withAlpha(0.6f));
+    g.drawText(juce::String(rows.size()) + (rows.size() == 1 ? " instance" : " instances")
+                   + (registry.isSharedAcrossProcesses() ? "" : " (this process)"),
+               header.reduced(4, 0), juce::Justification::centredLeft);
+
+    for (const auto& row : rows)
+    {
+        auto rowArea = bounds.removeFromTop(rowHeight).reduced(4, 1);
+
+        // Status dot
+        auto dotArea = rowArea.removeFromLeft(rowHeight).toFloat().reduced(4.0f);
+        g.setColour(getStatusColour(row.status));
+        g.fillEllipse(dotArea);
+
+        // Values on the right, name takes what is left
+        auto peakArea = rowArea.removeFromRight(50);
+        auto lraArea = rowArea.removeFromRight(50);
+
+        g.setColour(Palette::Foreground.withAlpha(0.7f));
+        g.drawText(juce::String(row.peak, 1) + " dB", peakArea, juce::Justification::centredRight);
+        g.drawText(juce::String(row.lra, 1) + " LU", lraArea, juce::Justification::centredRight);
+
+        const auto name = row.name.isNotEmpty() ? row.name : "Instance " + juce::String(row.slotIndex + 1);
+        g.setColour(row.isInThisProcess ? Palette::Foreground : Palette::Foreground.withAlpha(0.8f));
+        g.drawText(name, rowArea.reduced(4, 0), juce::Justification::centredLeft);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "Constants.h"       // For Palette and status helpers
+#include "SessionRegistry.h" // For the shared instance table
+
+//==============================================================================
+/**
+ * Lists every DynamicsDoctor instance in the session, one row per instance.
+ *
+ * Rows show the track name, a status dot, the reported LRA and the block peak.
+ * Instances in the Loss state are listed first so over-compressed buses stand
+ * out without opening their editors. The component sizes its own height to fit
+ * all rows, so it is meant to live inside a juce::Viewport.
+ */
+class SessionOverviewComponent : public juce::Component,
+                                 private juce::Timer
+{
+public:
+    /** Creates an overview reading from the given registry. */
+    explicit SessionOverviewComponent (SessionRegistry& registry);
+
+    /** Destructor. */
+    ~SessionOverviewComponent() override;
+
+    //==============================================================================
+    /** @internal */
+    void paint (juce::Graphics& g) override;
+
+    /** Height in pixels of one instance row. */
+    static constexpr int rowHeight = 18;
+
+private:
+    //==============================================================================
+    /** Re-reads the registry and resizes to fit the rows. */
+    void timerCallback() override;
+
+    SessionRegistry& registry;
+    juce::Array<SessionRegistry::SlotSnapshot> rows;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionOverviewComponent)
+};
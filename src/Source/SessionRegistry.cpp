@@ -0,0 +1,235 @@
+#include "SessionRegistry.h"
+#include <juce_audio_processors/juce_audio_processors.h> // For juce::PluginHostType
+#include <cstring> // For std::memcpy
+
+namespace
+{
+    constexpr const char* sharedSegmentFilePrefix = "DynamicsDoctorSession_v1";
+    constexpr int heartbeatIntervalMs = 1000;
+    constexpr int maxSeqlockReadAttempts = 64; // A writer that died mid-update must not hang the reader
+
+    juce::uint64 createProcessToken()
+    {
+        // Any non-zero value works; zero marks a free slot.
+        juce::uint64 token = 0;
+        while (token == 0)
+            token = static_cast<juce::uint64> (juce::Random::getSystemRandom().nextInt64());
+        return token;
+    }
+
+    /**
+     * One file per user and host. Plugin helper processes of a sandboxing host
+     * report that host, so their instances still meet in the same file.
+     */
+    juce::File getSharedSegmentFile()
+    {
+        const auto name = juce::String(sharedSegmentFilePrefix)
+                        + "_" + juce::SystemStats::getLogonName()
+                        + "_" + juce::PluginHostType().getHostDescription();
+
+        return juce::File::getSpecialLocation(juce::File::tempDirectory)
+                   .getChildFile(juce::File::createLegalFileName(name.removeCharacters(" ")) + ".bin");
+    }
+}
+
+//==============================================================================
+SessionRegistry::SessionRegistry()
+    : processToken (createProcessToken())
+{
+    if (! mapSharedSegment())
+    {
+        DBG("SessionRegistry: Shared segment unavailable, using a process-local table.");
+        localSegment = std::make_unique<Segment>(); // Value-initialised, so every slot starts free
+        segment = localSegment.get();
+    }
+
+    startTimer(heartbeatIntervalMs);
+}
+
+SessionRegistry::~SessionRegistry()
+{
+    stopTimer();
+
+    // Instances normally release their slots first; this only matters if one leaked.
+    for (auto slotIndex : ownedSlots)
+        segment->slots[slotIndex].ownerToken.store(0);
+}
+
+//==============================================================================
+bool SessionRegistry::mapSharedSegment()
+{
+    auto file = getSharedSegmentFile();
+    const auto requiredSize = static_cast<juce::int64> (sizeof (Segment));
+
+    // Grow the file with zeros (a zeroed slot is a free slot). FileOutputStream
+    // appends, so data written by other processes is left untouched.
+    if (file.getSize() < requiredSize)
+    {
+        juce::FileOutputStream out (file);
+        if (! out.openedOk())
+            return false;
+
+        out.writeRepeatedByte(0, static_cast<size_t> (requiredSize - file.getSize()));
+        out.flush();
+    }
+
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite, false);
+    if (mapping->getData() == nullptr || mapping->getSize() < sizeof (Segment))
+        return false;
+
+    mappedFile = std::move(mapping);
+    segment = static_cast<Segment*> (mappedFile->getData());
+    return true;
+}
+
+//==============================================================================
+int SessionRegistry::claimSlot()
+{
+    const auto now = juce::Time::currentTimeMillis();
+
+    for (int i = 0; i < maxSlots; ++i)
+    {
+        auto& slot = segment->slots[i];
+        auto owner = slot.ownerToken.load();
+
+        // Free slots, and slots whose owner stopped sending heartbeats (crashed process)
+        const bool isFree = (owner == 0);
+        const bool isStale = ! isFree && (now - slot.heartbeatMs.load()) > staleSlotTimeoutMs;
+
+        if ((isFree || isStale) && slot.ownerToken.compare_exchange_strong(owner, processToken))
+        {
+            slot.heartbeatMs.store(now);
+            slot.sequence.store(0);
+            slot.lra.store(0.0f);
+            slot.peak.store(ParameterDefaults::peak);
+            slot.status.store(static_cast<juce::int32> (DynamicsStatus::AwaitingAudio));
+            setSlotName(i, {});
+
+            ownedSlots.add(i);
+            return i;
+        }
+    }
+
+    DBG("SessionRegistry::claimSlot - All " << maxSlots << " slots are in use.");
+    return -1;
+}
+
+void SessionRegistry::releaseSlot (int slotIndex)
+{
+    if (! juce::isPositiveAndBelow(slotIndex, maxSlots))
+        return;
+
+    auto expected = processToken;
+    segment->slots[slotIndex].ownerToken.compare_exchange_strong(expected, 0);
+    ownedSlots.removeFirstMatchingValue(slotIndex);
+}
+
+//==============================================================================
+void SessionRegistry::publish (int slotIndex, float lra, float peak, DynamicsStatus status) noexcept
+{
+    if (! juce::isPositiveAndBelow(slotIndex, maxSlots))
+        return;
+
+    auto& slot = segment->slots[slotIndex];
+
+    // Seqlock write: odd sequence means an update is in progress.
+    slot.sequence.fetch_add(1, std::memory_order_acq_rel);
+    slot.lra.store(lra, std::memory_order_relaxed);
+    slot.peak.store(peak, std::memory_order_relaxed);
+    slot.status.store(static_cast<juce::int32> (status), std::memory_order_relaxed);
+    slot.sequence.fetch_add(1, std::memory_order_release);
+}
+
+void SessionRegistry::setSlotName (int slotIndex, const juce::String& name)
+{
+    if (! juce::isPositiveAndBelow(slotIndex, maxSlots))
+        return;
+
+    char bytes[maxNameLength] = {};
+    name.copyToUTF8(bytes, maxNameLength);
+
+    auto& slot = segment->slots[slotIndex];
+    slot.nameSequence.fetch_add(1, std::memory_order_acq_rel);
+
+    for (size_t w = 0; w < slot.nameWords.size(); ++w)
+    {
+        juce::uint64 word = 0;
+        std::memcpy(&word, bytes + w * sizeof (word), sizeof (word));
+        slot.nameWords[w].store(word, std::memory_order_relaxed);
+    }
+
+    slot.nameSequence.fetch_add(1, std::memory_order_release);
+}
+
+//==============================================================================
+juce::String SessionRegistry::readSlotName (const Slot& slot) const
+{
+    char bytes[maxNameLength + 1] = {};
+
+    for (int attempt = 0; attempt < maxSeqlockReadAttempts; ++attempt)
+    {
+        const auto before = slot.nameSequence.load(std::memory_order_acquire);
+        if ((before & 1u) != 0)
+            continue;
+
+        for (size_t w = 0; w < slot.nameWords.size(); ++w)
+        {
+            const auto word = slot.nameWords[w].load(std::memory_order_relaxed);
+            std::memcpy(bytes + w * sizeof (word), &word, sizeof (word));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.nameSequence.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    bytes[maxNameLength] = 0;
+    return juce::String::fromUTF8(bytes);
+}
+
+void SessionRegistry::collectSnapshots (juce::Array<SlotSnapshot>& result) const
+{
+    result.clearQuick();
+    const auto now = juce::Time::currentTimeMillis();
+
+    for (int i = 0; i < maxSlots; ++i)
+    {
+        const auto& slot = segment->slots[i];
+        const auto owner = slot.ownerToken.load();
+
+        if (owner == 0 || (now - slot.heartbeatMs.load()) > staleSlotTimeoutMs)
+            continue;
+
+        SlotSnapshot snapshot;
+        snapshot.slotIndex = i;
+        snapshot.isInThisProcess = (owner == processToken);
+
+        // Seqlock read: retry until we see the same even sequence before and after.
+        for (int attempt = 0; attempt < maxSeqlockReadAttempts; ++attempt)
+        {
+            const auto before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1u) != 0)
+                continue;
+
+            snapshot.lra = slot.lra.load(std::memory_order_relaxed);
+            snapshot.peak = slot.peak.load(std::memory_order_relaxed);
+            snapshot.status = static_cast<DynamicsStatus> (slot.status.load(std::memory_order_relaxed));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        snapshot.name = readSlotName(slot);
+        result.add(snapshot);
+    }
+}
+
+//==============================================================================
+void SessionRegistry::timerCallback()
+{
+    const auto now = juce::Time::currentTimeMillis();
+
+    for (auto slotIndex : ownedSlots)
+        segment->slots[slotIndex].heartbeatMs.store(now);
+}
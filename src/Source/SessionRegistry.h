@@ -0,0 +1,114 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "Constants.h" // For DynamicsStatus
+
+//==============================================================================
+/**
+ * Session-wide table of every running DynamicsDoctor instance.
+ *
+ * The table lives in a memory-mapped file in the temp directory, so instances
+ * hosted in separate plugin processes (sandboxed hosts) still share one view of
+ * the session. The file is named after the user and the host application, so
+ * other users and other hosts on the machine keep their own tables; two copies
+ * of the same host open at once share one. If the mapping cannot be created the
+ * registry falls back to a process-local table with the same layout.
+ *
+ * Each instance claims one fixed slot and publishes its LRA, peak and status
+ * into it with a seqlock write of a handful of scalars. Publishing is wait-free
+ * and costs the same no matter how many instances are registered; only the
+ * overview reader walks the whole table.
+ *
+ * Shared between instances through juce::SharedResourcePointer.
+ */
+class SessionRegistry : private juce::Timer
+{
+public:
+    static constexpr int maxSlots = 256;            // Instances visible in one session
+    static constexpr int maxNameLength = 32;        // Bytes of track name kept per slot (UTF-8)
+    static constexpr juce::int64 staleSlotTimeoutMs = 10000; // Slots without a heartbeat for this long are reclaimed
+
+    /** A consistent copy of one slot, as seen by the overview. */
+    struct SlotSnapshot
+    {
+        int slotIndex = -1;
+        juce::String name;
+        float lra = 0.0f;
+        float peak = ParameterDefaults::peak;
+        DynamicsStatus status = DynamicsStatus::AwaitingAudio;
+        bool isInThisProcess = false;
+    };
+
+    SessionRegistry();
+    ~SessionRegistry() override;
+
+    /**
+     * Claims a free slot for a new instance. Call from the message thread.
+     * @return The slot index, or -1 if the table is full
+     */
+    int claimSlot();
+
+    /** Returns a slot to the free pool. Call from the message thread. */
+    void releaseSlot (int slotIndex);
+
+    /**
+     * Publishes the latest measurement of an instance.
+     * Wait-free and allocation-free; safe to call from the audio thread.
+     */
+    void publish (int slotIndex, float lra, float peak, DynamicsStatus status) noexcept;
+
+    /** Sets the display name (usually the host track name) of a slot. */
+    void setSlotName (int slotIndex, const juce::String& name);
+
+    /** Copies every live slot into the given array, replacing its contents. */
+    void collectSnapshots (juce::Array<SlotSnapshot>& result) const;
+
+    /** True if the table is shared with other processes through a mapped file. */
+    bool isSharedAcrossProcesses() const noexcept { return mappedFile != nullptr; }
+
+private:
+    //==============================================================================
+    /**
+     * One instance entry. Every field is a lock-free atomic so the layout is
+     * valid in memory shared between processes.
+     */
+    struct Slot
+    {
+        std::atomic<juce::uint64> ownerToken;     // 0 = free, otherwise the owning process' token
+        std::atomic<juce::int64>  heartbeatMs;    // Last time the owning process confirmed the slot
+        std::atomic<juce::uint32> sequence;       // Seqlock guarding the measurement fields
+        std::atomic<float>        lra;
+        std::atomic<float>        peak;
+        std::atomic<juce::int32>  status;
+        std::atomic<juce::uint32> nameSequence;   // Seqlock guarding the name words
+        std::array<std::atomic<juce::uint64>, maxNameLength / 8> nameWords;
+    };
+
+    struct Segment
+    {
+        Slot slots[maxSlots];
+    };
+
+    static_assert (std::atomic<juce::uint64>::is_always_lock_free, "Shared slots need lock-free 64-bit atomics");
+    static_assert (std::atomic<float>::is_always_lock_free, "Shared slots need lock-free float atomics");
+
+    /** Refreshes the heartbeat of every slot owned by this process. */
+    void timerCallback() override;
+
+    bool mapSharedSegment();
+    juce::String readSlotName (const Slot& slot) const;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;  // Shared backing store, if available
+    std::unique_ptr<Segment> localSegment;                // Fallback when mapping fails
+    Segment* segment = nullptr;
+
+    const juce::uint64 processToken;                      // Identifies slots owned by this process
+    juce::Array<int> ownedSlots;                          // Message thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionRegistry)
+};
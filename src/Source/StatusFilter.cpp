@@ -0,0 +1,71 @@
+#include "StatusFilter.h"
+
+namespace
+{
+    /** Ordered from worst to best so hysteresis can tell which way the LRA is moving. */
+    int toLevel (DynamicsStatus status) noexcept
+    {
+        switch (status)
+        {
+            case DynamicsStatus::Loss:    return 0;
+            case DynamicsStatus::Reduced: return 1;
+            default:                      return 2;
+        }
+    }
+}
+
+//==============================================================================
+void StatusFilter::reset() noexcept
+{
+    hasStatus.fill(false);
+}
+
+PresetVerdicts StatusFilter::process (const PresetRegistry::Table& table, float measuredLRA, const SampleClock& clock) noexcept
+{
+    if (table.generation != tableGeneration)
+    {
+        // Indices may now refer to different presets
+        reset();
+        tableGeneration = table.generation;
+    }
+
+    auto verdicts = PresetVerdicts::evaluate(table, measuredLRA);
+    const auto now = clock.getNow();
+    const int numPresets = juce::jmin(static_cast<int>(table.presets.size()), PresetRegistry::maxPresets);
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        const auto& preset = table.presets[static_cast<size_t>(i)];
+        const auto index = static_cast<size_t>(i);
+
+        if (! hasStatus[index])
+        {
+            shownStatus[index] = verdicts.getStatus(i);
+            shownSince[index] = now;
+            hasStatus[index] = true;
+            continue;
+        }
+
+        // Judge with the LRA pulled back towards the shown status by the hysteresis
+        // band: moving up has to clear threshold + band, moving down threshold - band
+        const int shownLevel = toLevel(shownStatus[index]);
+        auto candidate = shownStatus[index];
+        const auto upward = PresetVerdicts::judge(preset, measuredLRA - preset.hysteresisLU);
+        const auto downward = PresetVerdicts::judge(preset, measuredLRA + preset.hysteresisLU);
+        if (toLevel(upward) > shownLevel)
+            candidate = upward;
+        else if (toLevel(downward) < shownLevel)
+            candidate = downward;
+
+        if (candidate != shownStatus[index]
+            && now - shownSince[index] >= clock.toSamples(preset.minDwellSeconds))
+        {
+            shownStatus[index] = candidate;
+            shownSince[index] = now;
+        }
+
+        verdicts = verdicts.withStatus(i, shownStatus[index]);
+    }
+
+    return verdicts;
+}
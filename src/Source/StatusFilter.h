@@ -0,0 +1,43 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+#include "PresetRegistry.h" // For PresetRegistry::Table, PresetVerdicts
+#include "SampleClock.h"
+
+//==============================================================================
+/**
+ * Steadies the per-preset verdicts so an LRA hovering at a threshold doesn't
+ * flip the status on every update.
+ *
+ * Two rules, both taken from each preset (hysteresisLU, minDwellSeconds):
+ * - Hysteresis: to move to another status the LRA has to cross the threshold
+ *   by hysteresisLU, in whichever direction it is moving.
+ * - Dwell: once a status has been shown, it stays for at least minDwellSeconds
+ *   of audio, however far the LRA moves.
+ *
+ * Target flags (below/above the preset's target range) are passed through
+ * unfiltered; they are informational and don't drive the traffic light.
+ *
+ * Audio thread only: no locks, no allocation.
+ */
+class StatusFilter
+{
+public:
+    /** Forgets every preset's status; the next update is accepted as it is. */
+    void reset() noexcept;
+
+    /**
+     * Judges every preset in the table against a new LRA and applies the
+     * filter. A table swap (new generation) resets the filter first.
+     * @return The filtered verdicts
+     */
+    PresetVerdicts process (const PresetRegistry::Table& table, float measuredLRA, const SampleClock& clock) noexcept;
+
+private:
+    std::array<DynamicsStatus, PresetRegistry::maxPresets> shownStatus {};   // Last accepted status per preset
+    std::array<juce::int64, PresetRegistry::maxPresets> shownSince {};       // Clock time of that change
+    std::array<bool, PresetRegistry::maxPresets> hasStatus {};               // False until a first verdict
+    juce::uint32 tableGeneration = 0;                                       // Table the states belong to
+};
@@ -0,0 +1,125 @@
+#include "TimingHistogram.h"
+#include <cmath> // For std::pow
+
+namespace
+{
+    // Cached once; the tick rate never changes while the process runs
+    const double nanosecondsPerTick = 1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+}
+
+//==============================================================================
+TimingHistogram::TimingHistogram()
+{
+    reset();
+}
+
+void TimingHistogram::reset() noexcept
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count.store(0, std::memory_order_relaxed);
+    maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+int TimingHistogram::getBucketIndex (juce::int64 nanoseconds) noexcept
+{
+    if (nanoseconds <= 0)
+        return 0;
+
+    // Highest set bit by binary search (portable, no intrinsics)
+    auto value = static_cast<juce::uint64>(nanoseconds);
+    int msb = 0;
+    for (int shift = 32; shift > 0; shift >>= 1)
+    {
+        if ((value >> shift) != 0)
+        {
+            value >>= shift;
+            msb += shift;
+        }
+    }
+
+    // The two bits below the highest one pick the quarter-octave
+    const auto ns = static_cast<juce::uint64>(nanoseconds);
+    const int subBucket = (msb >= 2) ? static_cast<int>((ns >> (msb - 2)) & 3u) : 0;
+    const int index = (msb - firstOctave) * bucketsPerOctave + subBucket;
+
+    return juce::jlimit(0, numBuckets - 1, index);
+}
+
+double TimingHistogram::getBucketUpperEdgeMicros (int bucketIndex) noexcept
+{
+    const int octave = firstOctave + bucketIndex / bucketsPerOctave;
+    const int subBucket = bucketIndex % bucketsPerOctave;
+    const double lowerNs = std::pow(2.0, octave) * (1.0 + subBucket / static_cast<double>(bucketsPerOctave));
+    const double widthNs = std::pow(2.0, octave) / bucketsPerOctave;
+    return (lowerNs + widthNs) / 1000.0;
+}
+
+//==============================================================================
+void TimingHistogram::record (juce::int64 elapsedTicks) noexcept
+{
+    const auto nanoseconds = static_cast<juce::int64>(static_cast<double>(elapsedTicks) * nanosecondsPerTick);
+
+    buckets[static_cast<size_t>(getBucketIndex(nanoseconds))].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    auto previousMax = maxNanoseconds.load(std::memory_order_relaxed);
+    while (nanoseconds > previousMax
+           && ! maxNanoseconds.compare_exchange_weak(previousMax, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+//==============================================================================
+TimingHistogram::Summary TimingHistogram::summarise() const
+{
+    // Copy the counts first so the percentiles come from one consistent pass
+    std::array<juce::uint32, numBuckets> counts;
+    juce::uint64 total = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Summary summary;
+    summary.count = total;
+    summary.maxMicros = static_cast<double>(maxNanoseconds.load(std::memory_order_relaxed)) / 1000.0;
+
+    if (total == 0)
+        return summary;
+
+    const auto p50Rank = (total + 1) / 2;
+    const auto p99Rank = total - total / 100;
+    juce::uint64 cumulative = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        const auto before = cumulative;
+        cumulative += counts[static_cast<size_t>(i)];
+
+        if (before < p50Rank && cumulative >= p50Rank)
+            summary.p50Micros = getBucketUpperEdgeMicros(i);
+        if (before < p99Rank && cumulative >= p99Rank)
+            summary.p99Micros = getBucketUpperEdgeMicros(i);
+    }
+
+    // A bucket edge can overshoot the exact maximum
+    summary.p50Micros = juce::jmin(summary.p50Micros, summary.maxMicros);
+    summary.p99Micros = juce::jmin(summary.p99Micros, summary.maxMicros);
+    return summary;
+}
+
+juce::String TimingHistogram::describeBuckets() const
+{
+    juce::String text;
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        const auto bucketCount = buckets[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+        if (bucketCount != 0)
+            text << "  <= " << juce::String(getBucketUpperEdgeMicros(i), 2) << " us: " << static_cast<int>(bucketCount) << "\n";
+    }
+    return text;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+/**
+ * Set to 0 to compile the timing instrumentation out completely.
+ * When compiled in, it can still be switched off at runtime.
+ */
+#ifndef DYNAMICSDOCTOR_TIMING_INSTRUMENTATION
+ #define DYNAMICSDOCTOR_TIMING_INSTRUMENTATION 1
+#endif
+
+/**
+ * Set to 1 to record timing from the start, e.g. in a profiling build.
+ * Otherwise it stays off until switched on from the editor's DSP menu.
+ */
+#ifndef DYNAMICSDOCTOR_TIMING_ENABLED_BY_DEFAULT
+ #define DYNAMICSDOCTOR_TIMING_ENABLED_BY_DEFAULT 0
+#endif
+
+//==============================================================================
+/**
+ * Lock-free histogram of execution times with logarithmic buckets.
+ *
+ * Buckets are quarter-octaves of nanoseconds from 128 ns to ~2 s, so the
+ * relative resolution is the same for a 2 µs meter call and a 10 ms spike.
+ * record() is wait-free and allocation-free (a few relaxed atomic adds),
+ * so it can run on the audio thread; summarise() can run on any thread.
+ */
+class TimingHistogram
+{
+public:
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int firstOctave = 7;       // 2^7 ns = 128 ns
+    static constexpr int numOctaves = 24;       // Up to 2^31 ns ~ 2.1 s
+    static constexpr int numBuckets = bucketsPerOctave * numOctaves;
+
+    /** Percentiles and extremes, in microseconds. */
+    struct Summary
+    {
+        juce::uint64 count = 0;
+        double p50Micros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+    };
+
+    TimingHistogram();
+
+    /** Adds one measurement. Wait-free. */
+    void record (juce::int64 elapsedTicks) noexcept;
+
+    /** Clears every bucket. Not synchronised with concurrent record() calls. */
+    void reset() noexcept;
+
+    /** Computes percentiles from the current bucket counts (upper bucket edges). */
+    Summary summarise() const;
+
+    /** Writes one line per non-empty bucket: upper edge in µs and count. */
+    juce::String describeBuckets() const;
+
+private:
+    static int getBucketIndex (juce::int64 nanoseconds) noexcept;
+    static double getBucketUpperEdgeMicros (int bucketIndex) noexcept;
+
+    std::array<std::atomic<juce::uint32>, numBuckets> buckets;
+    std::atomic<juce::uint64> count { 0 };
+    std::atomic<juce::int64> maxNanoseconds { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimingHistogram)
+};
+
+//==============================================================================
+/**
+ * Times the enclosing scope into a histogram when instrumentation is enabled.
+ * Costs one relaxed load when disabled.
+ */
+class ScopedTimingSample
+{
+public:
+    ScopedTimingSample (TimingHistogram& target, const std::atomic<bool>& enabled) noexcept
+      #if DYNAMICSDOCTOR_TIMING_INSTRUMENTATION
+        : histogram (enabled.load (std::memory_order_relaxed) ? &target : nullptr),
+          startTicks (histogram != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+      #endif
+    {
+       #if ! DYNAMICSDOCTOR_TIMING_INSTRUMENTATION
+        juce::ignoreUnused (target, enabled);
+       #endif
+    }
+
+    ~ScopedTimingSample()
+    {
+       #if DYNAMICSDOCTOR_TIMING_INSTRUMENTATION
+        if (histogram != nullptr)
+            histogram->record (juce::Time::getHighResolutionTicks() - startTicks);
+       #endif
+    }
+
+private:
+   #if DYNAMICSDOCTOR_TIMING_INSTRUMENTATION
+    TimingHistogram* histogram;
+    juce::int64 startTicks;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedTimingSample)
+};
@@ -50,8 +50,13 @@ void TrafficLightComponent::paint (juce::Graphics& g)
 void TrafficLightComponent::paintLight (juce::Graphics& g, const juce::Rectangle<float>& bounds, DynamicsStatus lightTargetStatus)
 {
     // Get visual properties based on light's target status and current component state
-    const juce::Colour fillColour = TrafficLightMetrics::getLightColour(lightTargetStatus, currentStatus);
+    juce::Colour fillColour = TrafficLightMetrics::getLightColour(lightTargetStatus, currentStatus);
     const juce::Colour borderColour = TrafficLightMetrics::getLightBorderColour(lightTargetStatus, currentStatus);
+
+    // A provisional verdict lights faintly until the measurement is complete
+    if (currentStatus == DynamicsStatus::Measuring && tentativeStatus == lightTargetStatus)
+        fillColour = getStatusColour(lightTargetStatus).withAlpha(TrafficLightMetrics::TentativeAlpha);
+
     const float borderThickness = TrafficLightMetrics::LightBorderThickness;
 
     // Draw light with fill and border
@@ -79,3 +84,12 @@ void TrafficLightComponent::setStatus (DynamicsStatus newStatus)
         repaint();
     }
 }
+
+void TrafficLightComponent::setTentativeStatus (DynamicsStatus newTentativeStatus)
+{
+    if (tentativeStatus != newTentativeStatus)
+    {
+        tentativeStatus = newTentativeStatus;
+        repaint();
+    }
+}
@@ -47,6 +47,12 @@ public:
      */
     void setStatus(DynamicsStatus newStatus);
 
+    /**
+     * Verdict on a provisional LRA, shown faintly while the status is Measuring.
+     * Pass Measuring when there is none.
+     */
+    void setTentativeStatus(DynamicsStatus newTentativeStatus);
+
 private:
     //==============================================================================
     /**
@@ -68,6 +74,9 @@ private:
     /** The current dynamics processing status being displayed. */
     DynamicsStatus currentStatus = DynamicsStatus::Bypassed;
 
+    /** Provisional verdict while measuring, Measuring if none. */
+    DynamicsStatus tentativeStatus = DynamicsStatus::Measuring;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TrafficLightComponent)
 };
@@ -0,0 +1,101 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath> // For std::sin, std::sqrt
+
+#include "../Source/AnalysisDecimator.h"
+
+namespace
+{
+    const double highSampleRates[] = { 88200.0, 96000.0, 176400.0, 192000.0, 352800.0, 384000.0 };
+
+    constexpr int blockSize = 512;
+    constexpr double settleSeconds = 0.2;           // Skipped before measuring, longer than any filter
+    constexpr double aliasOffsetHz = 5000.0;        // Test tones fold down to this frequency
+}
+
+//==============================================================================
+/**
+ * Frequency response of the decimation cascade at every high rate: flat to
+ * 20 kHz, and tones that would fold into the audible band rejected by the
+ * design attenuation.
+ */
+class AnalysisDecimatorTests : public juce::UnitTest
+{
+public:
+    AnalysisDecimatorTests() : juce::UnitTest ("Analysis decimator", "DynamicsDoctor") {}
+
+    void runTest() override
+    {
+        beginTest("Output lands in the 44.1/48 kHz family");
+        for (const auto sampleRate : highSampleRates)
+        {
+            AnalysisDecimator decimator;
+            decimator.prepare(sampleRate, 2, blockSize, true);
+            const double outputRate = decimator.getOutputSampleRate();
+            expect(outputRate == 44100.0 || outputRate == 48000.0, "Output rate " + juce::String (outputRate));
+            expectEquals(outputRate * decimator.getFactor(), sampleRate);
+
+            decimator.prepare(sampleRate, 2, blockSize, false);
+            expectEquals(decimator.getFactor(), 1);
+        }
+
+        beginTest("Passband is flat to 20 kHz");
+        for (const auto sampleRate : highSampleRates)
+            for (const double frequency : { 100.0, 1000.0, 10000.0, 16000.0, 20000.0 })
+                expectWithinAbsoluteError(measureGainDb(sampleRate, frequency), 0.0, 0.02,
+                                          juce::String (frequency) + " Hz at " + juce::String (sampleRate) + " Hz");
+
+        beginTest("Aliases into the audible band are rejected");
+        for (const auto sampleRate : highSampleRates)
+        {
+            AnalysisDecimator decimator;
+            decimator.prepare(sampleRate, 1, blockSize, true);
+            const double outputRate = decimator.getOutputSampleRate();
+
+            // Every multiple of the output rate, either side, folds onto aliasOffsetHz
+            for (double centre = outputRate; centre - aliasOffsetHz < sampleRate / 2.0; centre += outputRate)
+                for (const double frequency : { centre - aliasOffsetHz, centre + aliasOffsetHz })
+                    if (frequency < sampleRate / 2.0)
+                        expectLessThan(measureGainDb(sampleRate, frequency), -AnalysisDecimator::stopbandAttenuationDb + 1.0,
+                                       juce::String (frequency) + " Hz at " + juce::String (sampleRate) + " Hz");
+        }
+    }
+
+private:
+    /**
+     * Level of the decimated output relative to a sine input, measured over
+     * exactly one second after the filters have settled. The test frequencies
+     * and their aliases are whole hertz, so the window holds whole cycles.
+     */
+    static double measureGainDb (double sampleRate, double frequency)
+    {
+        AnalysisDecimator decimator;
+        decimator.prepare(sampleRate, 1, blockSize, true);
+        const auto outputRate = static_cast<int> (decimator.getOutputSampleRate());
+        const auto settleSamples = static_cast<int> (settleSeconds * outputRate);
+
+        constexpr double amplitude = 0.5;
+        const double phaseStep = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        juce::AudioBuffer<float> block (1, blockSize);
+        juce::int64 inputSample = 0;
+        int outputSample = 0;
+        double sumOfSquares = 0.0;
+
+        while (outputSample < settleSamples + outputRate)
+        {
+            auto* data = block.getWritePointer(0);
+            for (int i = 0; i < blockSize; ++i)
+                data[i] = static_cast<float> (amplitude * std::sin(phaseStep * static_cast<double> (inputSample++)));
+
+            const auto& output = decimator.process(block);
+            const auto* out = output.getReadPointer(0);
+            for (int i = 0; i < output.getNumSamples(); ++i, ++outputSample)
+                if (outputSample >= settleSamples && outputSample < settleSamples + outputRate)
+                    sumOfSquares += static_cast<double> (out[i]) * out[i];
+        }
+
+        const double rms = std::sqrt(sumOfSquares / outputRate);
+        return juce::Decibels::gainToDecibels(rms / (amplitude / juce::MathConstants<double>::sqrt2), -200.0);
+    }
+};
+
+static AnalysisDecimatorTests analysisDecimatorTests;
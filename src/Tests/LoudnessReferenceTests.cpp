@@ -0,0 +1,95 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>  // For std::sin
+#include <vector>
+
+#include "../Source/LoudnessMeter.h"
+
+namespace
+{
+    const double testSampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0, 352800.0, 384000.0 };
+
+    constexpr int blockSize = 512;
+    constexpr double toneHz = 1000.0;
+    constexpr double segmentSeconds = 20.0;
+    constexpr float lraToleranceLU = 1.0f;          // EBU Tech 3342 tolerance
+    constexpr float decimationToleranceLU = 0.1f;   // Decimated against full-rate analysis
+
+    /** An EBU Tech 3342 minimum-requirement signal: a stereo 1 kHz sine stepping through levels. */
+    struct ReferenceCase
+    {
+        const char* name;
+        std::vector<float> segmentLevelsDbfs;       // segmentSeconds each
+        float expectedLRA;
+    };
+
+    const std::vector<ReferenceCase> referenceCases = {
+        { "EBU 3342 case 1", { -20.0f, -30.0f },                          10.0f },
+        { "EBU 3342 case 2", { -20.0f, -15.0f },                           5.0f },
+        { "EBU 3342 case 3", { -40.0f, -20.0f },                          20.0f },
+        { "EBU 3342 case 4", { -50.0f, -35.0f, -20.0f, -35.0f, -50.0f },  15.0f }
+    };
+}
+
+//==============================================================================
+/**
+ * LoudnessMeter against the EBU Tech 3342 LRA test signals at every sample
+ * rate, through the decimation path from 88.2 kHz up, and decimated against
+ * full-rate analysis of the same signal.
+ */
+class LoudnessReferenceTests : public juce::UnitTest
+{
+public:
+    LoudnessReferenceTests() : juce::UnitTest ("Loudness reference corpus", "DynamicsDoctor") {}
+
+    void runTest() override
+    {
+        for (const auto& reference : referenceCases)
+        {
+            beginTest(reference.name);
+            for (const auto sampleRate : testSampleRates)
+                expectWithinAbsoluteError(measureLRA(reference, sampleRate, true), reference.expectedLRA, lraToleranceLU,
+                                          juce::String (sampleRate) + " Hz");
+        }
+
+        beginTest("Decimation leaves LRA unchanged");
+        for (const auto& reference : referenceCases)
+            for (const double sampleRate : { 96000.0, 192000.0 })
+                expectWithinAbsoluteError(measureLRA(reference, sampleRate, true), measureLRA(reference, sampleRate, false),
+                                          decimationToleranceLU, juce::String (reference.name) + " at " + juce::String (sampleRate) + " Hz");
+    }
+
+private:
+    static float measureLRA (const ReferenceCase& reference, double sampleRate, bool shouldDecimate)
+    {
+        LoudnessMeter meter;
+        meter.setDecimationEnabled(shouldDecimate);
+        meter.prepare(sampleRate, 2, blockSize);
+
+        const double phaseStep = juce::MathConstants<double>::twoPi * toneHz / sampleRate;
+        const auto segmentSamples = static_cast<juce::int64> (segmentSeconds * sampleRate);
+        juce::AudioBuffer<float> block (2, blockSize);
+        juce::int64 sample = 0;
+
+        for (const auto levelDbfs : reference.segmentLevelsDbfs)
+        {
+            const double amplitude = juce::Decibels::decibelsToGain(static_cast<double> (levelDbfs));
+            for (juce::int64 remaining = segmentSamples; remaining > 0;)
+            {
+                const int numSamples = static_cast<int> (juce::jmin<juce::int64> (blockSize, remaining));
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto value = static_cast<float> (amplitude * std::sin(phaseStep * static_cast<double> (sample++)));
+                    block.setSample(0, i, value);
+                    block.setSample(1, i, value);
+                }
+
+                meter.processBlock(juce::AudioBuffer<float> (block.getArrayOfWritePointers(), 2, numSamples));
+                remaining -= numSamples;
+            }
+        }
+
+        return meter.getLoudnessRange();
+    }
+};
+
+static LoudnessReferenceTests loudnessReferenceTests;
@@ -0,0 +1,22 @@
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+ * Runs every unit test in the "DynamicsDoctor" category and returns non-zero
+ * if any of them failed, so a build script can gate on the result. Pass a
+ * random seed as the first argument to repeat a failing run.
+ */
+int main (int argc, char* argv[])
+{
+    const juce::int64 seed = (argc > 1) ? juce::String (argv[1]).getLargeIntValue() : 0;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("DynamicsDoctor", seed);
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}
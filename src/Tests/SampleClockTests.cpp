@@ -0,0 +1,99 @@
+#include <juce_core/juce_core.h>
+#include <cmath> // For std::abs
+
+#include "../Source/SampleClock.h" // Also MeasurementDeadlines
+#include "../Source/Constants.h"   // For lraRates
+
+namespace
+{
+    // Every rate a host may run us at, including the odd low ones
+    const double testSampleRates[] = { 11025.0, 22050.0, 32000.0, 44100.0, 48000.0, 88200.0,
+                                       96000.0, 176400.0, 192000.0, 352800.0, 384000.0 };
+
+    constexpr double simulatedSeconds = 24.0 * 3600.0;    // One day of continuous audio
+    constexpr int maxBlockSize = 4096;
+}
+
+//==============================================================================
+/**
+ * Long-run checks of SampleClock and PeriodicSchedule: a day of audio at every
+ * sample rate and every LRA rate, in random block sizes, split at the LRA
+ * deadlines the way DynamicsDoctorProcessor::analyseQueuedRange() does.
+ */
+class SampleClockTests : public juce::UnitTest
+{
+public:
+    SampleClockTests() : juce::UnitTest ("Sample clock", "DynamicsDoctor") {}
+
+    void runTest() override
+    {
+        beginTest("State-machine deadlines are whole seconds of samples");
+        for (const auto sampleRate : testSampleRates)
+        {
+            // As DynamicsDoctorProcessor::prepareToPlay() sets them up
+            SampleClock clock;
+            clock.prepare(sampleRate);
+            MeasurementDeadlines deadlines;
+            deadlines.prepare(clock);
+
+            const auto context = juce::String (sampleRate) + " Hz";
+            expectEquals(deadlines.measuringDuration, clock.toSamples(MeasurementDeadlines::measuringSeconds), context);
+            expectEquals(deadlines.audioTimeout, clock.toSamples(MeasurementDeadlines::audioTimeoutSeconds), context);
+            expectEquals(deadlines.measuringDuration, static_cast<juce::int64> (15.0 * sampleRate), context + ": measuring window");
+            expectEquals(deadlines.audioTimeout, static_cast<juce::int64> (300.0 * sampleRate), context + ": audio timeout");
+        }
+
+        for (const auto sampleRate : testSampleRates)
+        {
+            beginTest("A day of LRA deadlines at " + juce::String (sampleRate) + " Hz");
+            for (const auto& option : lraRates)
+                runSchedule(sampleRate, option.hz);
+        }
+    }
+
+private:
+    void runSchedule (double sampleRate, double lraHz)
+    {
+        auto random = getRandom();
+        const double periodSamples = sampleRate / lraHz;
+        const juce::int64 origin = random.nextInt(static_cast<int> (periodSamples)); // Staggered like a session slot
+        const auto totalSamples = static_cast<juce::int64> (simulatedSeconds * sampleRate);
+
+        SampleClock clock;
+        clock.prepare(sampleRate);
+        PeriodicSchedule schedule;
+        schedule.start(origin, periodSamples);
+
+        juce::int64 evaluations = 0;
+        double worstErrorSamples = 0.0;
+
+        while (clock.getNow() < totalSamples)
+        {
+            int remaining = static_cast<int> (juce::jmin<juce::int64> (1 + random.nextInt(maxBlockSize),
+                                                                       totalSamples - clock.getNow()));
+            while (remaining > 0)
+            {
+                const auto samplesToDeadline = schedule.getNextDeadline() - clock.getNow();
+                const int chunk = static_cast<int> (juce::jlimit<juce::int64> (0, remaining, samplesToDeadline));
+                clock.advance(chunk);
+                remaining -= chunk;
+
+                if (clock.getNow() >= schedule.getNextDeadline())
+                {
+                    const double exactDeadline = static_cast<double> (origin) + static_cast<double> (evaluations) * periodSamples;
+                    worstErrorSamples = juce::jmax(worstErrorSamples, std::abs(static_cast<double> (clock.getNow()) - exactDeadline));
+                    ++evaluations;
+                    schedule.advance();
+                }
+            }
+        }
+
+        const auto context = juce::String (sampleRate) + " Hz, LRA every " + juce::String (1.0 / lraHz) + " s";
+        expectEquals(clock.getNow(), totalSamples, context);
+        expectLessOrEqual(worstErrorSamples, 0.5, context + ": deadline off the exact time");
+        expect(schedule.getNextDeadline() > totalSamples, context + ": a deadline was missed");
+        expect(evaluations >= static_cast<juce::int64> (simulatedSeconds * lraHz) - 1, context + ": too few evaluations");
+    }
+};
+
+static SampleClockTests sampleClockTests;